@@ -0,0 +1,119 @@
+/*
+ * inflate_benchmark.cpp
+ * Written by Dalton Messmer <messmer.dalton@gmail.com>.
+ *
+ * Compares the inflate backends on real DMF files.
+ *
+ * Usage:
+ *     inflate_benchmark [--iterations N] file1.dmf [file2.dmf ...]
+ */
+
+#include "utils/inflate.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace d2m;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result
+{
+	double best_ms = 0.0;
+	double mean_ms = 0.0;
+	std::vector<char> output;
+};
+
+auto Run(const std::vector<char>& input, InflateBackend backend, unsigned iterations) -> Result
+{
+	Result result;
+	result.output = Inflate(input.data(), input.size(), backend); // Warm up
+
+	double total_ms = 0.0;
+	result.best_ms = -1.0;
+	for (unsigned i = 0; i < iterations; ++i)
+	{
+		const auto start = Clock::now();
+		const auto output = Inflate(input.data(), input.size(), backend);
+		const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		total_ms += ms;
+		if (result.best_ms < 0.0 || ms < result.best_ms) { result.best_ms = ms; }
+	}
+	result.mean_ms = total_ms / iterations;
+	return result;
+}
+
+void PrintResult(std::string_view name, const Result& result)
+{
+	const double mb = result.output.size() / (1024.0 * 1024.0);
+	std::cout << "    " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(3)
+		<< "best " << std::setw(9) << result.best_ms << " ms, mean " << std::setw(9) << result.mean_ms << " ms, "
+		<< std::setprecision(1) << std::setw(8) << mb / (result.best_ms / 1000.0) << " MiB/s\n";
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+	unsigned iterations = 100;
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--iterations" && i + 1 < argc) { iterations = std::max(std::stoi(argv[++i]), 1); }
+		else { files.push_back(arg); }
+	}
+
+	if (files.empty())
+	{
+		std::cerr << "Usage: inflate_benchmark [--iterations N] file1.dmf [file2.dmf ...]\n";
+		return 1;
+	}
+
+	int status = 0;
+	for (const auto& file : files)
+	{
+		std::ifstream stream{file, std::ios_base::in | std::ios_base::binary};
+		if (!stream)
+		{
+			std::cerr << "Failed to open " << file << "\n";
+			status = 1;
+			continue;
+		}
+		const std::vector<char> input{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+
+		try
+		{
+			const auto streaming = Run(input, InflateBackend::kStreaming, iterations);
+			const auto one_shot = Run(input, InflateBackend::kOneShot, iterations);
+
+			std::cout << file << " (" << input.size() << " -> " << one_shot.output.size() << " bytes)\n";
+			PrintResult("streaming", streaming);
+			PrintResult("one-shot", one_shot);
+			std::cout << "    one-shot speedup: " << std::setprecision(2) << streaming.best_ms / one_shot.best_ms << "x\n";
+
+			if (streaming.output != one_shot.output)
+			{
+				std::cerr << "    ERROR: The backends produced different output\n";
+				status = 1;
+			}
+		}
+		catch (const InflateError& e)
+		{
+			std::cerr << file << ": " << e.what() << "\n";
+			status = 1;
+		}
+	}
+
+	return status;
+}
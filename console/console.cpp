@@ -88,7 +88,8 @@ auto main(int argc, char** argv) -> int
 
 	////////// IMPORT //////////
 
-	// Import the input file by inferring module type:
+	// Import the input file by inferring module type, skipping data the output type won't need:
+	input->SetConversionTarget(io.output_type);
 	input->Import(io.input_file);
 	if (input->HandleResults()) { return 1; }
 
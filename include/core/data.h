@@ -12,7 +12,17 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
 
 namespace d2m {
 
@@ -26,6 +36,8 @@ enum class DataStorageType
 	kNone,
 	kCOR,  // Iteration order: Channels --> Orders --> (Pattern) Rows
 	kORC,  // Iteration order: Orders --> (Pattern) Rows --> Channels
+	kColumnar, // Same iteration order as kCOR, but each row field is stored in its own dense array (see RowColumns)
+	kPacked,   // Same iteration order as kCOR, but rows are stored as per-channel variable-size byte strings (see RowPacking)
 };
 
 /*
@@ -80,6 +92,31 @@ struct PatternMetadataDefault
 template<class ModuleClass>
 struct PatternMetadata : public PatternMetadataDefault {};
 
+/*
+ * Modules which use DataStorageType::kColumnar must specialize RowColumns to describe how
+ * their Row is split into columns. The specialization provides:
+ *   using Types = std::tuple<...>; // The element type of each column
+ *   static auto Split(const Row<ModuleClass>& row) -> Types;
+ *   static auto Join(const Types& columns) -> Row<ModuleClass>;
+ */
+
+template<class ModuleClass>
+struct RowColumns;
+
+/*
+ * Modules which use DataStorageType::kPacked must specialize RowPacking to describe how
+ * their Row is encoded. A channel's metadata decides the size of its packed rows, so a
+ * channel's patterns are only allocated once ModuleData::SetChannelMetadata is called for it,
+ * which must happen exactly once per channel.
+ * The specialization provides:
+ *   static auto GetPackedSize(const ChannelMetadata<ModuleClass>& metadata) -> std::size_t;
+ *   static void Pack(const Row<ModuleClass>& row, const ChannelMetadata<ModuleClass>& metadata, std::byte* out);
+ *   static auto Unpack(const std::byte* in, const ChannelMetadata<ModuleClass>& metadata) -> Row<ModuleClass>;
+ */
+
+template<class ModuleClass>
+struct RowPacking;
+
 
 namespace detail {
 	/*
@@ -124,20 +161,22 @@ namespace detail {
 		using RowType = Row<ModuleClass>;
 		using PatternType = RowType*; // [row]
 
-		using PatternMatrixType = std::vector<std::vector<PatternIndex>>; // [channel][order]
+		using PatternMatrixType = std::vector<PatternIndex>; // [channel * num_orders + order]
 		using NumPatternsType = std::vector<PatternIndex>; // [channel]
-		using PatternStorageType = std::vector<PatternType*>; // [channel][pattern id]
+		using PatternStorageType = std::vector<RowType>; // [channel offset + pattern id * num_rows + row]
 		using PatternMetadataType = PatternMetadata<ModuleClass>;
 		using PatternMetadataStorageType = std::vector<std::vector<PatternMetadataType>>; // [channel][pattern id]
 
-		auto GetPatternId(ChannelIndex channel, OrderIndex order) const -> PatternIndex { return pattern_matrix_[channel][order]; }
-		void SetPatternId(ChannelIndex channel, OrderIndex order, PatternIndex pattern_id) { pattern_matrix_[channel][order] = pattern_id; }
+		auto GetPatternId(ChannelIndex channel, OrderIndex order) const -> PatternIndex { return pattern_matrix_[channel * num_orders_ + order]; }
+		void SetPatternId(ChannelIndex channel, OrderIndex order, PatternIndex pattern_id) { pattern_matrix_[channel * num_orders_ + order] = pattern_id; }
 		auto GetNumPatterns(ChannelIndex channel) const -> PatternIndex { return num_patterns_[channel]; }
 		void SetNumPatterns(ChannelIndex channel, PatternIndex num_patterns) { num_patterns_[channel] = num_patterns; }
-		auto GetPattern(ChannelIndex channel, OrderIndex order) const -> PatternType { return patterns_[channel][GetPatternId(channel, order)]; }
-		void SetPattern(ChannelIndex channel, OrderIndex order, PatternType&& pattern) { patterns_[channel][GetPatternId(channel, order)] = std::move(pattern); } // TODO: Deep copy?
-		auto GetPatternById(ChannelIndex channel, PatternIndex pattern_id) const -> PatternType { return patterns_[channel][pattern_id]; }
-		void SetPatternById(ChannelIndex channel, PatternIndex pattern_id, PatternType&& pattern) { patterns_[channel][pattern_id] = std::move(pattern); } // TODO: Deep copy?
+		auto GetPattern(ChannelIndex channel, OrderIndex order) const -> const RowType* { return GetPatternById(channel, GetPatternId(channel, order)); }
+		auto GetPattern(ChannelIndex channel, OrderIndex order) -> PatternType { return GetPatternById(channel, GetPatternId(channel, order)); }
+		void SetPattern(ChannelIndex channel, OrderIndex order, const RowType* pattern) { SetPatternById(channel, GetPatternId(channel, order), pattern); }
+		auto GetPatternById(ChannelIndex channel, PatternIndex pattern_id) const -> const RowType* { return patterns_.data() + PatternOffset(channel, pattern_id); }
+		auto GetPatternById(ChannelIndex channel, PatternIndex pattern_id) -> PatternType { return patterns_.data() + PatternOffset(channel, pattern_id); }
+		void SetPatternById(ChannelIndex channel, PatternIndex pattern_id, const RowType* pattern) { std::copy_n(pattern, num_rows_, GetPatternById(channel, pattern_id)); }
 		auto GetRow(ChannelIndex channel, OrderIndex order, RowIndex row) const -> const RowType& { return GetPattern(channel, order)[row]; }
 		void SetRow(ChannelIndex channel, OrderIndex order, RowIndex row, const RowType& row_value) { GetPattern(channel, order)[row] = row_value; }
 		auto GetRowById(ChannelIndex channel, PatternIndex pattern_id, RowIndex row) const -> const RowType& { return GetPatternById(channel, pattern_id)[row]; }
@@ -151,22 +190,9 @@ namespace detail {
 
 		void CleanUpData() override
 		{
-			if (!num_patterns_.empty())
-			{
-				ChannelIndex channel = 0;
-				for (const auto& num_patterns : num_patterns_)
-				{
-					for (PatternIndex pattern_id = 0; pattern_id < num_patterns; ++pattern_id)
-					{
-						delete[] patterns_[channel][pattern_id];
-						patterns_[channel][pattern_id] = nullptr;
-					}
-					delete[] patterns_[channel];
-					patterns_[channel] = nullptr;
-					++channel;
-				}
-				patterns_.clear();
-			}
+			patterns_.clear();
+			patterns_.shrink_to_fit();
+			channel_offsets_.clear();
 			pattern_matrix_.clear();
 			num_patterns_.clear();
 			pattern_metadata_.clear();
@@ -183,12 +209,7 @@ namespace detail {
 			num_orders_ = orders;
 			num_rows_ = rows;
 
-			pattern_matrix_.resize(num_channels_);
-
-			for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
-			{
-				pattern_matrix_[channel].resize(num_orders_);
-			}
+			pattern_matrix_.resize(static_cast<std::size_t>(num_channels_) * num_orders_);
 		}
 
 		void SetNumPatterns() override
@@ -197,39 +218,44 @@ namespace detail {
 
 			for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
 			{
-				num_patterns_[channel] = *std::max_element(pattern_matrix_[channel].begin(), pattern_matrix_[channel].end()) + 1;
+				const auto begin = pattern_matrix_.begin() + channel * num_orders_;
+				num_patterns_[channel] = *std::max_element(begin, begin + num_orders_) + 1;
 			}
 		}
 
 		void SetPatterns() override
 		{
-			patterns_.resize(num_channels_);
-			if constexpr (!std::is_empty_v<PatternMetadataType>)
+			// Every channel's patterns are stored back to back in a single allocation
+			channel_offsets_.resize(num_channels_);
+			std::size_t total_rows = 0;
+			for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
 			{
-				// Only set it if it's going to be used
-				pattern_metadata_.resize(num_channels_);
+				channel_offsets_[channel] = total_rows;
+				total_rows += static_cast<std::size_t>(num_patterns_[channel]) * num_rows_;
 			}
 
-			for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
-			{
-				const PatternIndex num_patterns = num_patterns_[channel];
-				patterns_[channel] = new PatternType[num_patterns];
+			patterns_.assign(total_rows, RowType{});
 
-				for (PatternIndex pattern_id = 0; pattern_id < num_patterns; ++pattern_id)
+			if constexpr (!std::is_empty_v<PatternMetadataType>)
+			{
+				// Only set it if it's going to be used
+				pattern_metadata_.resize(num_channels_);
+				for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
 				{
-					patterns_[channel][pattern_id] = new RowType[num_rows_]();
-					if constexpr (!std::is_empty_v<PatternMetadataType>)
-					{
-						// Only set it if it's going to be used
-						pattern_metadata_[channel].resize(num_patterns);
-					}
+					pattern_metadata_[channel].resize(num_patterns_[channel]);
 				}
 			}
 		}
 
+		auto PatternOffset(ChannelIndex channel, PatternIndex pattern_id) const -> std::size_t
+		{
+			return channel_offsets_[channel] + static_cast<std::size_t>(pattern_id) * num_rows_;
+		}
+
 		PatternMatrixType pattern_matrix_{}; // Stores patterns IDs for each channel and order in the pattern matrix
 		NumPatternsType num_patterns_{}; // Patterns per channel
-		PatternStorageType patterns_{}; // [channel][pattern id]
+		PatternStorageType patterns_{}; // Rows of every pattern of every channel
+		std::vector<std::size_t> channel_offsets_{}; // [channel] Index of the channel's first row in patterns_
 		PatternMetadataStorageType pattern_metadata_{}; // [channel][pattern id]
 	};
 
@@ -238,11 +264,11 @@ namespace detail {
 	{
 	public:
 		using RowType = Row<ModuleClass>;
-		using PatternType = RowType**; // [row][channel]
+		using PatternType = RowType*; // [row * num_channels + channel]
 
 		using PatternMatrixType = std::vector<PatternIndex>; // [order] (No per-channel patterns)
 		using NumPatternsType = PatternIndex; // (No per-channel patterns)
-		using PatternStorageType = std::vector<PatternType>; // [order]
+		using PatternStorageType = std::vector<RowType>; // [(pattern id * num_rows + row) * num_channels + channel]
 		using PatternMetadataType = PatternMetadata<ModuleClass>;
 		using PatternMetadataStorageType = std::vector<PatternMetadataType>; // [pattern id] (No per-channel patterns)
 
@@ -250,14 +276,21 @@ namespace detail {
 		void SetPatternId(OrderIndex order, PatternIndex pattern_id) { pattern_matrix_[order] = pattern_id; }
 		auto GetNumPatterns() const -> PatternIndex { return num_patterns_; }
 		void SetNumPatterns(PatternIndex num_patterns) { num_patterns_ = num_patterns; }
-		auto GetPattern(OrderIndex order) const -> PatternType { return patterns_[GetPatternId(order)]; }
-		void SetPattern(OrderIndex order, PatternType&& pattern) { patterns_[GetPatternId(order)] = std::move(pattern); } // TODO: Deep copy?
-		auto GetPatternById(PatternIndex pattern_id) const -> PatternType { return patterns_[pattern_id]; }
-		void SetPatternById(PatternIndex pattern_id, PatternType&& pattern) { patterns_[pattern_id] = std::move(pattern); } // TODO: Deep copy?
-		auto GetRow(ChannelIndex channel, OrderIndex order, RowIndex row) const -> const RowType& { return GetPattern(order)[row][channel]; }
-		void SetRow(ChannelIndex channel, OrderIndex order, RowIndex row, const RowType& row_value) { GetPattern(order)[row][channel] = row_value; }
-		auto GetRowById(ChannelIndex channel, PatternIndex pattern_id, RowIndex row) const -> const RowType& { return GetPatternById(pattern_id)[row][channel]; }
-		void SetRowById(ChannelIndex channel, PatternIndex pattern_id, RowIndex row, const RowType& row_value) { GetPatternById(pattern_id)[row][channel] = row_value; }
+		auto GetPattern(OrderIndex order) const -> const RowType* { return GetPatternById(GetPatternId(order)); }
+		auto GetPattern(OrderIndex order) -> PatternType { return GetPatternById(GetPatternId(order)); }
+		void SetPattern(OrderIndex order, const RowType* pattern) { SetPatternById(GetPatternId(order), pattern); }
+		auto GetPatternById(PatternIndex pattern_id) const -> const RowType* { return patterns_.data() + PatternOffset(pattern_id); }
+		auto GetPatternById(PatternIndex pattern_id) -> PatternType { return patterns_.data() + PatternOffset(pattern_id); }
+		void SetPatternById(PatternIndex pattern_id, const RowType* pattern) { std::copy_n(pattern, PatternSize(), GetPatternById(pattern_id)); }
+		// Row spans are the num_channels contiguous rows (one per channel) at a given pattern row
+		auto GetRowSpan(OrderIndex order, RowIndex row) const -> const RowType* { return GetPattern(order) + row * num_channels_; }
+		auto GetRowSpan(OrderIndex order, RowIndex row) -> RowType* { return GetPattern(order) + row * num_channels_; }
+		auto GetRowSpanById(PatternIndex pattern_id, RowIndex row) const -> const RowType* { return GetPatternById(pattern_id) + row * num_channels_; }
+		auto GetRowSpanById(PatternIndex pattern_id, RowIndex row) -> RowType* { return GetPatternById(pattern_id) + row * num_channels_; }
+		auto GetRow(ChannelIndex channel, OrderIndex order, RowIndex row) const -> const RowType& { return GetRowSpan(order, row)[channel]; }
+		void SetRow(ChannelIndex channel, OrderIndex order, RowIndex row, const RowType& row_value) { GetRowSpan(order, row)[channel] = row_value; }
+		auto GetRowById(ChannelIndex channel, PatternIndex pattern_id, RowIndex row) const -> const RowType& { return GetRowSpanById(pattern_id, row)[channel]; }
+		void SetRowById(ChannelIndex channel, PatternIndex pattern_id, RowIndex row, const RowType& row_value) { GetRowSpanById(pattern_id, row)[channel] = row_value; }
 		auto GetPatternMetadata(PatternIndex pattern_id) const -> const PatternMetadataType& { return pattern_metadata_[pattern_id]; }
 		void SetPatternMetadata(PatternIndex pattern_id, const PatternMetadataType& pattern_metadata) { pattern_metadata_[pattern_id] = pattern_metadata; }
 
@@ -267,18 +300,8 @@ namespace detail {
 
 		void CleanUpData() override
 		{
-			for (PatternIndex pattern_id = 0; pattern_id < num_patterns_; ++pattern_id)
-			{
-				for (RowIndex row = 0; row < num_rows_; ++row)
-				{
-					delete[] patterns_[pattern_id][row];
-					patterns_[pattern_id][row] = nullptr;
-				}
-				delete[] patterns_[pattern_id];
-				patterns_[pattern_id] = nullptr;
-			}
 			patterns_.clear();
-
+			patterns_.shrink_to_fit();
 			pattern_matrix_.clear();
 			num_patterns_ = 0;
 			pattern_metadata_.clear();
@@ -300,27 +323,404 @@ namespace detail {
 
 		void SetPatterns() override
 		{
-			patterns_.resize(num_patterns_);
+			// Every pattern is stored back to back in a single allocation, in [pattern][row][channel] order
+			patterns_.assign(num_patterns_ * PatternSize(), RowType{});
 			if constexpr (!std::is_empty_v<PatternMetadataType>)
 			{
 				// Only set it if it's going to be used
 				pattern_metadata_.resize(num_patterns_);
 			}
+		}
+
+		auto PatternSize() const -> std::size_t { return static_cast<std::size_t>(num_rows_) * num_channels_; }
+		auto PatternOffset(PatternIndex pattern_id) const -> std::size_t { return pattern_id * PatternSize(); }
+
+		PatternMatrixType pattern_matrix_{}; // Stores patterns IDs for each order in the pattern matrix
+		NumPatternsType num_patterns_{}; // Number of patterns
+		PatternStorageType patterns_{}; // Rows of every pattern
+		PatternMetadataStorageType pattern_metadata_{}; // [pattern id]
+	};
+
+	template<class Tuple>
+	struct ColumnVectors;
+
+	template<class... Ts>
+	struct ColumnVectors<std::tuple<Ts...>>
+	{
+		static_assert(!(std::is_same_v<Ts, bool> || ...), "std::vector<bool> columns cannot be safely written by multiple threads");
+		using Type = std::tuple<std::vector<Ts>...>;
+	};
+
+	template<class ModuleClass>
+	class ModuleDataStorage<DataStorageType::kColumnar, ModuleClass> : public ModuleDataStorageBase
+	{
+	public:
+		using RowType = Row<ModuleClass>;
+		using ColumnsType = RowColumns<ModuleClass>;
+		using ColumnTypes = typename ColumnsType::Types;
+		template<std::size_t column>
+		using ColumnType = std::tuple_element_t<column, ColumnTypes>;
+
+		static constexpr std::size_t kNumColumns = std::tuple_size_v<ColumnTypes>;
+
+		using PatternMatrixType = std::vector<PatternIndex>; // [channel * num_orders + order]
+		using NumPatternsType = std::vector<PatternIndex>; // [channel]
+		using PatternStorageType = typename ColumnVectors<ColumnTypes>::Type; // [column][channel offset + pattern id * num_rows + row]
+		using PatternMetadataType = PatternMetadata<ModuleClass>;
+		using PatternMetadataStorageType = std::vector<std::vector<PatternMetadataType>>; // [channel][pattern id]
+
+		auto GetPatternId(ChannelIndex channel, OrderIndex order) const -> PatternIndex { return pattern_matrix_[channel * num_orders_ + order]; }
+		void SetPatternId(ChannelIndex channel, OrderIndex order, PatternIndex pattern_id) { pattern_matrix_[channel * num_orders_ + order] = pattern_id; }
+		auto GetNumPatterns(ChannelIndex channel) const -> PatternIndex { return num_patterns_[channel]; }
+		void SetNumPatterns(ChannelIndex channel, PatternIndex num_patterns) { num_patterns_[channel] = num_patterns; }
+		// Rows are assembled from the columns, so they are returned by value
+		auto GetRow(ChannelIndex channel, OrderIndex order, RowIndex row) const -> RowType { return GetRowById(channel, GetPatternId(channel, order), row); }
+		void SetRow(ChannelIndex channel, OrderIndex order, RowIndex row, const RowType& row_value) { SetRowById(channel, GetPatternId(channel, order), row, row_value); }
+		auto GetRowById(ChannelIndex channel, PatternIndex pattern_id, RowIndex row) const -> RowType
+		{
+			const std::size_t index = PatternOffset(channel, pattern_id) + row;
+			return std::apply([index](const auto&... columns) { return ColumnsType::Join(ColumnTypes{columns[index]...}); }, patterns_);
+		}
+		void SetRowById(ChannelIndex channel, PatternIndex pattern_id, RowIndex row, const RowType& row_value)
+		{
+			SetColumns(PatternOffset(channel, pattern_id) + row, ColumnsType::Split(row_value), std::make_index_sequence<kNumColumns>{});
+		}
+		// A pattern's values for one column; num_rows contiguous elements
+		template<std::size_t column>
+		auto GetColumn(ChannelIndex channel, OrderIndex order) const -> const ColumnType<column>* { return GetColumnById<column>(channel, GetPatternId(channel, order)); }
+		template<std::size_t column>
+		auto GetColumnById(ChannelIndex channel, PatternIndex pattern_id) const -> const ColumnType<column>* { return std::get<column>(patterns_).data() + PatternOffset(channel, pattern_id); }
+		template<std::size_t column>
+		auto GetColumnById(ChannelIndex channel, PatternIndex pattern_id) -> ColumnType<column>* { return std::get<column>(patterns_).data() + PatternOffset(channel, pattern_id); }
+		auto GetPatternMetadata(ChannelIndex channel, PatternIndex pattern_id) const -> const PatternMetadataType& { return pattern_metadata_[channel][pattern_id]; }
+		void SetPatternMetadata(ChannelIndex channel, PatternIndex pattern_id, const PatternMetadataType& pattern_metadata) { pattern_metadata_[channel][pattern_id] = pattern_metadata; }
+
+	protected:
+		ModuleDataStorage() = default;
+		~ModuleDataStorage() override { CleanUpData(); }
+
+		void CleanUpData() override
+		{
+			std::apply([](auto&... columns) { ((columns.clear(), columns.shrink_to_fit()), ...); }, patterns_);
+			channel_offsets_.clear();
+			pattern_matrix_.clear();
+			num_patterns_.clear();
+			pattern_metadata_.clear();
+			num_channels_ = 0;
+			num_orders_ = 0;
+			num_rows_ = 0;
+		}
+
+		void SetPatternMatrix(ChannelIndex channels, OrderIndex orders, RowIndex rows) override
+		{
+			CleanUpData();
+
+			num_channels_ = channels;
+			num_orders_ = orders;
+			num_rows_ = rows;
+
+			pattern_matrix_.resize(static_cast<std::size_t>(num_channels_) * num_orders_);
+		}
+
+		void SetNumPatterns() override
+		{
+			num_patterns_.resize(num_channels_);
+
+			for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
+			{
+				const auto begin = pattern_matrix_.begin() + channel * num_orders_;
+				num_patterns_[channel] = *std::max_element(begin, begin + num_orders_) + 1;
+			}
+		}
+
+		void SetPatterns() override
+		{
+			// Every column holds all channels' patterns back to back, laid out the same way as kCOR's rows
+			channel_offsets_.resize(num_channels_);
+			std::size_t total_rows = 0;
+			for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
+			{
+				channel_offsets_[channel] = total_rows;
+				total_rows += static_cast<std::size_t>(num_patterns_[channel]) * num_rows_;
+			}
+
+			// Value-initialize each column with the corresponding field of a value-initialized row
+			SetDefaultColumns(total_rows, ColumnsType::Split(RowType{}), std::make_index_sequence<kNumColumns>{});
 
-			for (PatternIndex pattern_id = 0; pattern_id < num_patterns_; ++pattern_id)
+			if constexpr (!std::is_empty_v<PatternMetadataType>)
 			{
-				patterns_[pattern_id] = new RowType*[num_rows_];
-				for (RowIndex row = 0; row < num_rows_; ++row)
+				// Only set it if it's going to be used
+				pattern_metadata_.resize(num_channels_);
+				for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
 				{
-					patterns_[pattern_id][row] = new RowType[num_channels_]();
+					pattern_metadata_[channel].resize(num_patterns_[channel]);
 				}
 			}
 		}
 
-		PatternMatrixType pattern_matrix_{}; // Stores patterns IDs for each order in the pattern matrix
-		NumPatternsType num_patterns_{}; // Number of patterns
-		PatternStorageType patterns_{}; // [pattern id]
-		PatternMetadataStorageType pattern_metadata_{}; // [pattern id]
+		auto PatternOffset(ChannelIndex channel, PatternIndex pattern_id) const -> std::size_t
+		{
+			return channel_offsets_[channel] + static_cast<std::size_t>(pattern_id) * num_rows_;
+		}
+
+		template<std::size_t... columns>
+		void SetColumns(std::size_t index, const ColumnTypes& values, std::index_sequence<columns...>)
+		{
+			((std::get<columns>(patterns_)[index] = std::get<columns>(values)), ...);
+		}
+
+		template<std::size_t... columns>
+		void SetDefaultColumns(std::size_t size, const ColumnTypes& values, std::index_sequence<columns...>)
+		{
+			(std::get<columns>(patterns_).assign(size, std::get<columns>(values)), ...);
+		}
+
+		PatternMatrixType pattern_matrix_{}; // Stores patterns IDs for each channel and order in the pattern matrix
+		NumPatternsType num_patterns_{}; // Patterns per channel
+		PatternStorageType patterns_{}; // One vector per column
+		std::vector<std::size_t> channel_offsets_{}; // [channel] Index of the channel's first row in each column
+		PatternMetadataStorageType pattern_metadata_{}; // [channel][pattern id]
+	};
+
+	template<class ModuleClass>
+	class ModuleDataStorage<DataStorageType::kPacked, ModuleClass> : public ModuleDataStorageBase
+	{
+	public:
+		using RowType = Row<ModuleClass>;
+		using RowPackingType = RowPacking<ModuleClass>;
+		using ChannelMetadataType = ChannelMetadata<ModuleClass>;
+
+		using PatternMatrixType = std::vector<PatternIndex>; // [channel * num_orders + order]
+		using NumPatternsType = std::vector<PatternIndex>; // [channel]
+		using PatternStorageType = std::vector<std::byte>; // Packed rows of every pattern block
+		using PatternMetadataType = PatternMetadata<ModuleClass>;
+		using PatternMetadataStorageType = std::vector<std::vector<PatternMetadataType>>; // [channel][pattern id]
+
+		auto GetPatternId(ChannelIndex channel, OrderIndex order) const -> PatternIndex { return pattern_matrix_[channel * num_orders_ + order]; }
+		void SetPatternId(ChannelIndex channel, OrderIndex order, PatternIndex pattern_id) { pattern_matrix_[channel * num_orders_ + order] = pattern_id; }
+		auto GetNumPatterns(ChannelIndex channel) const -> PatternIndex { return num_patterns_[channel]; }
+		void SetNumPatterns(ChannelIndex channel, PatternIndex num_patterns) { num_patterns_[channel] = num_patterns; }
+		// Rows are unpacked on access, so they are returned by value
+		auto GetRow(ChannelIndex channel, OrderIndex order, RowIndex row) const -> RowType { return GetRowById(channel, GetPatternId(channel, order), row); }
+		void SetRow(ChannelIndex channel, OrderIndex order, RowIndex row, const RowType& row_value) { SetRowById(channel, GetPatternId(channel, order), row, row_value); }
+		auto GetRowById(ChannelIndex channel, PatternIndex pattern_id, RowIndex row) const -> RowType { return RowPackingType::Unpack(GetPackedRow(channel, pattern_id, row), packing_[channel]); }
+		void SetRowById(ChannelIndex channel, PatternIndex pattern_id, RowIndex row, const RowType& row_value)
+		{
+			assert(row_sizes_[channel] != 0 && "SetChannelMetadata must be called before the channel's rows are accessed");
+			const std::size_t block = UnshareBlock(channel, pattern_id);
+			RowPackingType::Pack(row_value, packing_[channel], patterns_.data() + blocks_[block].offset + row * row_sizes_[channel]);
+			blocks_[block].hash.reset();
+		}
+		auto GetPackedRowSize(ChannelIndex channel) const -> std::size_t { return row_sizes_[channel]; }
+		auto GetPackedRow(ChannelIndex channel, PatternIndex pattern_id, RowIndex row) const -> const std::byte*
+		{
+			assert(row_sizes_[channel] != 0 && "SetChannelMetadata must be called before the channel's rows are accessed");
+			return patterns_.data() + blocks_[GetPatternBlock(channel, pattern_id)].offset + row * row_sizes_[channel];
+		}
+		auto GetPatternMetadata(ChannelIndex channel, PatternIndex pattern_id) const -> const PatternMetadataType& { return pattern_metadata_[channel][pattern_id]; }
+		void SetPatternMetadata(ChannelIndex channel, PatternIndex pattern_id, const PatternMetadataType& pattern_metadata) { pattern_metadata_[channel][pattern_id] = pattern_metadata; }
+
+		/*
+		 * Pattern pool: Patterns whose packed rows are identical, whether in the same channel or not, can share
+		 * one block of rows. PoolPatterns hashes every pattern and merges the duplicates. Pattern IDs are unchanged.
+		 * Writing a row of a shared pattern gives that pattern its own copy first. The copy is appended to the
+		 * row storage, and the block it was copied from is still used by the other patterns, so no block is ever
+		 * left unused. The row storage only shrinks again when PoolPatterns is called, which also compacts it.
+		 * Pointers returned by GetPackedRow are invalidated by PoolPatterns and by writes to shared patterns.
+		 */
+		void PoolPatterns()
+		{
+			PatternStorageType pooled_patterns;
+			pooled_patterns.reserve(patterns_.size());
+			std::vector<PatternBlock> pooled_blocks;
+			std::unordered_multimap<std::size_t, std::size_t> blocks_by_hash; // hash --> pooled block
+
+			for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
+			{
+				for (PatternIndex pattern_id = 0; pattern_id < num_patterns_[channel]; ++pattern_id)
+				{
+					std::size_t& block_index = pattern_blocks_[channel_patterns_[channel] + pattern_id];
+					const PatternBlock& block = blocks_[block_index];
+					const std::byte* rows = patterns_.data() + block.offset;
+					const std::size_t hash = HashRows(block);
+
+					const auto [begin, end] = blocks_by_hash.equal_range(hash);
+					const auto iter = std::find_if(begin, end, [&](const auto& pair) {
+						const PatternBlock& other = pooled_blocks[pair.second];
+						return other.size == block.size && std::memcmp(pooled_patterns.data() + other.offset, rows, block.size) == 0;
+					});
+
+					if (iter != end)
+					{
+						block_index = iter->second;
+						++pooled_blocks[block_index].refs;
+						continue;
+					}
+
+					pooled_blocks.push_back({pooled_patterns.size(), block.size, 1, hash});
+					pooled_patterns.insert(pooled_patterns.end(), rows, rows + block.size);
+					blocks_by_hash.emplace(hash, pooled_blocks.size() - 1);
+					block_index = pooled_blocks.size() - 1;
+				}
+			}
+
+			pooled_patterns.shrink_to_fit();
+			patterns_ = std::move(pooled_patterns);
+			blocks_ = std::move(pooled_blocks);
+		}
+
+		// Patterns with the same block index have identical rows
+		auto GetPatternBlock(ChannelIndex channel, PatternIndex pattern_id) const -> std::size_t { return pattern_blocks_[channel_patterns_[channel] + pattern_id]; }
+		auto GetNumPatternBlocks() const -> std::size_t { return blocks_.size(); }
+		// Content hash of a pattern's current rows. Cached by PoolPatterns; patterns written to since then are hashed on each call.
+		auto GetPatternHash(ChannelIndex channel, PatternIndex pattern_id) const -> std::size_t
+		{
+			const PatternBlock& block = blocks_[GetPatternBlock(channel, pattern_id)];
+			return block.hash ? *block.hash : HashRows(block);
+		}
+
+	protected:
+		ModuleDataStorage() = default;
+		~ModuleDataStorage() override { CleanUpData(); }
+
+		struct PatternBlock
+		{
+			std::size_t offset; // Index of the block's first byte in patterns_
+			std::size_t size;   // num_rows * packed row size
+			std::size_t refs;   // Number of patterns using this block
+			std::optional<std::size_t> hash; // Hash of the rows. Reset whenever the rows are written to.
+		};
+
+		auto HashRows(const PatternBlock& block) const -> std::size_t
+		{
+			return std::hash<std::string_view>{}({reinterpret_cast<const char*>(patterns_.data() + block.offset), block.size});
+		}
+
+		void CleanUpData() override
+		{
+			patterns_.clear();
+			patterns_.shrink_to_fit();
+			blocks_.clear();
+			pattern_blocks_.clear();
+			channel_patterns_.clear();
+			packing_.clear();
+			row_sizes_.clear();
+			pattern_matrix_.clear();
+			num_patterns_.clear();
+			pattern_metadata_.clear();
+			num_channels_ = 0;
+			num_orders_ = 0;
+			num_rows_ = 0;
+		}
+
+		void SetPatternMatrix(ChannelIndex channels, OrderIndex orders, RowIndex rows) override
+		{
+			CleanUpData();
+
+			num_channels_ = channels;
+			num_orders_ = orders;
+			num_rows_ = rows;
+
+			pattern_matrix_.resize(static_cast<std::size_t>(num_channels_) * num_orders_);
+		}
+
+		void SetNumPatterns() override
+		{
+			num_patterns_.resize(num_channels_);
+
+			for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
+			{
+				const auto begin = pattern_matrix_.begin() + channel * num_orders_;
+				num_patterns_[channel] = *std::max_element(begin, begin + num_orders_) + 1;
+			}
+		}
+
+		void SetPatterns() override
+		{
+			// Every pattern starts out with a block of its own. The rows themselves are allocated by SetChannelPacking.
+			channel_patterns_.resize(num_channels_);
+			std::size_t total_patterns = 0;
+			for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
+			{
+				channel_patterns_[channel] = total_patterns;
+				total_patterns += num_patterns_[channel];
+			}
+
+			blocks_.assign(total_patterns, {0, 0, 1, std::nullopt});
+			pattern_blocks_.resize(total_patterns);
+			std::iota(pattern_blocks_.begin(), pattern_blocks_.end(), 0);
+
+			packing_.resize(num_channels_);
+			row_sizes_.assign(num_channels_, 0);
+
+			if constexpr (!std::is_empty_v<PatternMetadataType>)
+			{
+				// Only set it if it's going to be used
+				pattern_metadata_.resize(num_channels_);
+				for (ChannelIndex channel = 0; channel < num_channels_; ++channel)
+				{
+					pattern_metadata_[channel].resize(num_patterns_[channel]);
+				}
+			}
+		}
+
+		/*
+		 * Allocates every pattern of the channel, with each row set to a value-initialized row.
+		 * Must be called exactly once per channel, before any of the channel's rows are accessed.
+		 */
+		void SetChannelPacking(ChannelIndex channel, const ChannelMetadataType& channel_metadata)
+		{
+			assert(row_sizes_[channel] == 0 && "A channel's packing can only be set once");
+			const std::size_t row_size = RowPackingType::GetPackedSize(channel_metadata);
+			assert(row_size != 0 && "Packed rows must not be empty");
+			const std::size_t pattern_size = row_size * num_rows_;
+			packing_[channel] = channel_metadata;
+			row_sizes_[channel] = row_size;
+
+			const std::size_t channel_offset = patterns_.size();
+			patterns_.resize(channel_offset + pattern_size * num_patterns_[channel]);
+			for (PatternIndex pattern_id = 0; pattern_id < num_patterns_[channel]; ++pattern_id)
+			{
+				blocks_[channel_patterns_[channel] + pattern_id] = {channel_offset + pattern_id * pattern_size, pattern_size, 1, std::nullopt};
+			}
+
+			if (channel_offset == patterns_.size()) { return; } // The channel has no patterns
+
+			std::byte* rows = patterns_.data() + channel_offset;
+			RowPackingType::Pack(RowType{}, channel_metadata, rows);
+			for (std::size_t offset = channel_offset + row_size; offset < patterns_.size(); offset += row_size)
+			{
+				std::copy_n(rows, row_size, patterns_.data() + offset);
+			}
+		}
+
+		// Gives a pattern which shares its block with other patterns a copy of its own. Returns the pattern's block.
+		auto UnshareBlock(ChannelIndex channel, PatternIndex pattern_id) -> std::size_t
+		{
+			std::size_t& block_index = pattern_blocks_[channel_patterns_[channel] + pattern_id];
+			if (blocks_[block_index].refs == 1) { return block_index; }
+
+			PatternBlock block = blocks_[block_index];
+			--blocks_[block_index].refs;
+
+			const std::size_t offset = patterns_.size();
+			patterns_.resize(offset + block.size);
+			std::copy_n(patterns_.data() + block.offset, block.size, patterns_.data() + offset);
+
+			blocks_.push_back({offset, block.size, 1, block.hash});
+			block_index = blocks_.size() - 1;
+			return block_index;
+		}
+
+		PatternMatrixType pattern_matrix_{}; // Stores patterns IDs for each channel and order in the pattern matrix
+		NumPatternsType num_patterns_{}; // Patterns per channel
+		PatternStorageType patterns_{}; // Rows of every pattern block
+		std::vector<PatternBlock> blocks_{}; // [block]
+		std::vector<std::size_t> pattern_blocks_{}; // [channel_patterns_[channel] + pattern id] The block holding each pattern's rows
+		std::vector<std::size_t> channel_patterns_{}; // [channel] Index of the channel's first pattern in pattern_blocks_
+		std::vector<ChannelMetadataType> packing_{}; // [channel] The channel metadata each channel's rows were packed with
+		std::vector<std::size_t> row_sizes_{}; // [channel] Size in bytes of each packed row
+		PatternMetadataStorageType pattern_metadata_{}; // [channel][pattern id]
 	};
 
 	/*
@@ -394,7 +794,16 @@ public:
 	/////// GETTERS / SETTERS ///////
 
 	auto GetChannelMetadata(ChannelIndex channel) const -> const ChannelMetadataType& { return channel_metadata_[channel]; }
-	void SetChannelMetadata(ChannelIndex channel, const ChannelMetadataType& channelMetadata) { channel_metadata_[channel] = channelMetadata; }
+	void SetChannelMetadata(ChannelIndex channel, const ChannelMetadataType& channelMetadata)
+	{
+		channel_metadata_[channel] = channelMetadata;
+		if constexpr (storage_type == DataStorageType::kPacked)
+		{
+			// The channel's packed row size is now known, so its patterns can be allocated.
+			// With kPacked storage, this must be called exactly once per channel, before the channel's rows are accessed.
+			Storage::SetChannelPacking(channel, channelMetadata);
+		}
+	}
 
 	static constexpr auto GetStorageType() -> DataStorageType { return storage_type; }
 
@@ -11,9 +11,13 @@
 #include "core/factory.h"
 #include "core/status.h"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <ostream>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace d2m {
 
@@ -27,6 +31,9 @@ using ModulePtr = std::shared_ptr<Module>;
 using ConversionOptions = ConversionOptionsBase;
 using ConversionOptionsPtr = std::shared_ptr<ConversionOptions>;
 
+// Receives the exported module file's data. Called exactly once per successful export, with the whole file.
+using ExportSink = std::function<void(const std::byte* data, std::size_t size)>;
+
 // Specialized Info class for Modules
 template<>
 struct Info<ModuleBase> : public InfoBase
@@ -66,12 +73,46 @@ public:
 	 */
 	auto Import(const std::string& filename) -> bool;
 
+	/*
+	 * Import a module from a caller-owned buffer holding the module file's contents,
+	 * compressed or not. The buffer only needs to outlive this call.
+	 * Returns true upon failure
+	 */
+	auto Import(const void* data, std::size_t size) -> bool;
+
+	/*
+	 * Hints which module type this module will be converted to after it is imported,
+	 * which lets importers skip data the converter for that type never uses.
+	 * A module imported this way may lack data needed for other conversions.
+	 * ModuleType::kNone (the default) imports everything.
+	 */
+	void SetConversionTarget(ModuleType type) { conversion_target_ = type; }
+	auto GetConversionTarget() const -> ModuleType { return conversion_target_; }
+
 	/*
 	 * Export module to the specified file
 	 * Returns true upon failure
 	 */
 	auto Export(const std::string& filename) -> bool;
 
+	/*
+	 * Export module into buffer, replacing its contents
+	 * Returns true upon failure
+	 */
+	auto Export(std::vector<std::byte>& buffer) -> bool;
+
+	/*
+	 * Export module by writing it to a stream opened in binary mode
+	 * Returns true upon failure
+	 */
+	auto Export(std::ostream& stream) -> bool;
+
+	/*
+	 * Export module by passing its data to sink. The sink is not called if the export fails.
+	 * Returns true upon failure
+	 */
+	auto Export(const ExportSink& sink) -> bool;
+
 	/*
 	 * Converts the module to the specified type using the provided conversion options
 	 */
@@ -106,7 +147,9 @@ protected:
 	// Import() and Export() and Convert() are wrappers for these methods, which must be implemented by a module class:
 
 	virtual void ImportImpl(const std::string& filename) = 0;
+	virtual void ImportImpl(const void* data, std::size_t size) = 0;
 	virtual void ExportImpl(const std::string& filename) = 0;
+	virtual void ExportImpl(std::vector<std::byte>& buffer) = 0;
 	virtual void ConvertImpl(const ModulePtr& input) = 0;
 
 	auto GetOptions() const -> ConversionOptionsPtr { return options_; }
@@ -115,6 +158,7 @@ protected:
 
 private:
 	ConversionOptionsPtr options_;
+	ModuleType conversion_target_ = ModuleType::kNone;
 };
 
 } // namespace d2m
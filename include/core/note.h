@@ -9,7 +9,6 @@
 
 #include <cassert>
 #include <cstdint>
-#include <variant>
 
 namespace d2m {
 
@@ -79,22 +78,48 @@ namespace NoteTypes
 	constexpr auto operator==(const Off&, const Off&) -> bool { return true; };
 };
 
-using NoteSlot = std::variant<NoteTypes::Empty, NoteTypes::Note, NoteTypes::Off>;
 using Note = NoteTypes::Note; // For convenience
 
-constexpr auto NoteIsEmpty(const NoteSlot& note) -> bool { return note.index() == NoteTypes::kEmpty; }
-constexpr auto NoteHasPitch(const NoteSlot& note) -> bool { return note.index() == NoteTypes::kNote; }
-constexpr auto NoteIsOff(const NoteSlot& note) -> bool { return note.index() == NoteTypes::kOff; }
-constexpr auto GetNote(const NoteSlot& note) -> const Note&
+/*
+ * Holds an Empty note slot, a Note, or a note Off in a single byte.
+ * A Note is stored as (octave << 4) | pitch. Pitches only go up to 11, so the two
+ * largest byte values never hold a Note and are reserved for Empty and Off.
+ */
+class NoteSlot
 {
-	assert(NoteHasPitch(note) && "NoteSlot variant must be using the Note alternative");
-	return std::get<Note>(note);
-}
+public:
+	static constexpr std::uint8_t kEmptyValue = 0xFF;
+	static constexpr std::uint8_t kOffValue = 0xFE;
+
+	constexpr NoteSlot() : value_(kEmptyValue) {}
+	constexpr NoteSlot(NoteTypes::Empty) : value_(kEmptyValue) {}
+	constexpr NoteSlot(NoteTypes::Off) : value_(kOffValue) {}
+	constexpr NoteSlot(Note note) : value_(static_cast<std::uint8_t>((note.octave << 4) | static_cast<std::uint8_t>(note.pitch))) {}
+
+	// Returns NoteTypes::kEmpty, NoteTypes::kNote, or NoteTypes::kOff
+	constexpr auto GetType() const -> int
+	{
+		return value_ < kOffValue ? NoteTypes::kNote : (value_ == kOffValue ? NoteTypes::kOff : NoteTypes::kEmpty);
+	}
+
+	constexpr auto GetValue() const -> std::uint8_t { return value_; }
+
+	constexpr auto operator==(NoteSlot rhs) const -> bool { return value_ == rhs.value_; }
+	constexpr auto operator!=(NoteSlot rhs) const -> bool { return value_ != rhs.value_; }
+
+private:
+	std::uint8_t value_;
+};
+
+static_assert(sizeof(NoteSlot) == 1);
 
-constexpr auto GetNote(NoteSlot& note) -> Note&
+constexpr auto NoteIsEmpty(NoteSlot note) -> bool { return note.GetValue() == NoteSlot::kEmptyValue; }
+constexpr auto NoteHasPitch(NoteSlot note) -> bool { return note.GetValue() < NoteSlot::kOffValue; }
+constexpr auto NoteIsOff(NoteSlot note) -> bool { return note.GetValue() == NoteSlot::kOffValue; }
+constexpr auto GetNote(NoteSlot note) -> Note
 {
-	assert(NoteHasPitch(note) && "NoteSlot variant must be using the Note alternative");
-	return std::get<Note>(note);
+	assert(NoteHasPitch(note) && "NoteSlot must be holding a Note");
+	return Note{static_cast<NotePitch>(note.GetValue() & 0x0F), static_cast<std::uint8_t>(note.GetValue() >> 4)};
 }
 
 constexpr auto GetNoteRange(const Note& low, const Note& high) -> int
@@ -12,10 +12,13 @@
 #include "core/effects.h"
 #include "core/note.h"
 
+#include <algorithm>
 #include <array>
+#include <bitset>
 #include <cassert>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <tuple>
@@ -43,14 +46,93 @@ struct OneShotDefinitionTag {};
 template<typename... input_t>
 using tuple_cat_t = decltype(std::tuple_cat(std::declval<input_t>()...));
 
+/*
+ * Stores one type of state data as a dense array of positions alongside a separate array of values,
+ * so searching and advancing by position never pulls the values through the cache.
+ * Elements are (position, value) pairs in write order.
+ */
+template<typename T>
+class ColumnarStateVector
+{
+public:
+	using value_type = T;
+
+	auto size() const -> std::size_t { return positions_.size(); }
+	auto empty() const -> bool { return positions_.empty(); }
+
+	auto Position(std::size_t index) const -> OrderRowPosition { assert(index < size()); return positions_[index]; }
+	auto Value(std::size_t index) const -> const T& { assert(index < size()); return values_[index].value; }
+	auto Value(std::size_t index) -> T& { assert(index < size()); return values_[index].value; }
+
+	// Returns the index of the first element after pos, searching from index first onward. Positions must be sorted.
+	auto UpperBound(OrderRowPosition pos, std::size_t first = 0) const -> std::size_t
+	{
+		return static_cast<std::size_t>(std::upper_bound(positions_.begin() + first, positions_.end(), pos) - positions_.begin());
+	}
+
+	void PushBack(OrderRowPosition pos, T&& val)
+	{
+		positions_.push_back(pos);
+		values_.push_back({std::move(val)});
+	}
+
+	void Insert(std::size_t index, OrderRowPosition pos, const T& val)
+	{
+		positions_.insert(positions_.begin() + index, pos);
+		values_.insert(values_.begin() + index, {val});
+	}
+
+private:
+	// Keeps std::vector<bool> from being used for bool values
+	struct BoxedValue { T value; };
+
+	std::vector<OrderRowPosition> positions_;
+	std::vector<BoxedValue> values_;
+};
+
+// Stores one type of state data as a single array of (position, value) pairs. Same interface as ColumnarStateVector.
+template<typename T>
+class PairStateVector
+{
+public:
+	using value_type = T;
+
+	auto size() const -> std::size_t { return data_.size(); }
+	auto empty() const -> bool { return data_.empty(); }
+
+	auto Position(std::size_t index) const -> OrderRowPosition { assert(index < size()); return data_[index].first; }
+	auto Value(std::size_t index) const -> const T& { assert(index < size()); return data_[index].second; }
+	auto Value(std::size_t index) -> T& { assert(index < size()); return data_[index].second; }
+
+	// Returns the index of the first element after pos, searching from index first onward. Positions must be sorted.
+	auto UpperBound(OrderRowPosition pos, std::size_t first = 0) const -> std::size_t
+	{
+		const auto iter = std::upper_bound(data_.begin() + first, data_.end(), pos, [](OrderRowPosition lhs, const auto& elem) { return lhs < elem.first; });
+		return static_cast<std::size_t>(iter - data_.begin());
+	}
+
+	void PushBack(OrderRowPosition pos, T&& val) { data_.emplace_back(pos, std::move(val)); }
+	void Insert(std::size_t index, OrderRowPosition pos, const T& val) { data_.insert(data_.begin() + index, std::pair{pos, val}); }
+
+private:
+	std::vector<std::pair<OrderRowPosition, T>> data_;
+};
+
+// Chosen at build time with the STATE_STORAGE CMake option
+#ifdef DMF2MOD_STATE_PAIRS
+template<typename T> using StateVector = PairStateVector<T>;
+#else
+template<typename T> using StateVector = ColumnarStateVector<T>;
+#endif
+
 template<typename T>
 struct WrappedStateData {};
 
 template<typename... Ts>
 struct WrappedStateData<std::tuple<Ts...>>
 {
-	// type is either an empty tuple or a tuple with each Ts wrapped in a vector of pairs
-	using type = std::conditional_t<sizeof...(Ts) == 0, std::tuple<>, std::tuple<std::vector<std::pair<OrderRowPosition, Ts>>...>>;
+	// type is either an empty tuple or a tuple with each Ts wrapped in a StateVector
+	using type = std::conditional_t<sizeof...(Ts) == 0, std::tuple<>, std::tuple<StateVector<Ts>...>>;
 };
 
 template<typename... T>
@@ -254,7 +336,7 @@ public:
 	// Single tuple of all data types stored by this state
 	using StateData = detail::tuple_cat_t<typename CommonDef::StateDataCommon, StateDataModuleSpecific>;
 
-	// Single tuple of all wrapped data types stored by this state. They should all be vectors of pairs.
+	// Single tuple of all wrapped data types stored by this state. They should all be StateVectors.
 	using StateDataWrapped = detail::WrappedStateDataType<StateData>;
 
 	// Returns an immutable reference to state data at index state_data_index
@@ -271,8 +353,13 @@ public:
 		return std::get<state_data_index + CommonDef::kCommonCount>(data_);
 	}
 
+	// Whether every state data and one-shot data vector is ordered by position. Readers can only binary search them if so.
+	auto IsSorted() const -> bool { return sorted_; }
+	void SetUnsorted() { sorted_ = false; }
+
 private:
 	StateDataWrapped data_; // Stores all state data
+	bool sorted_ = true;
 };
 
 template<class CommonDef, typename... Ts>
@@ -289,7 +376,7 @@ public:
 	// Single tuple of all data types stored by this one-shot state
 	using OneShotData = detail::tuple_cat_t<typename CommonDef::OneShotDataCommon, OneShotDataModuleSpecific>;
 
-	// Single tuple of all wrapped data types stored by this one-shot state. They should all be vectors of pairs.
+	// Single tuple of all wrapped data types stored by this one-shot state. They should all be StateVectors.
 	using OneShotDataWrapped = detail::WrappedStateDataType<OneShotData>;
 
 	// Returns an immutable reference to one-shot data at index oneshot_data_index
@@ -366,6 +453,20 @@ void CopyState(Reader const* reader, Tuple& t, const Function& f)
 	CopyStateHelper<start>(reader, t, f, std::make_integer_sequence<int, detail::abs(start) + end>{});
 }
 
+// Compile-time for loop helper
+template<int start, class Reader, class Tuple, typename Function, int... integers>
+void ReadStateHelper(Reader const* reader, Tuple& t, const Function& f, std::integer_sequence<int, integers...>&&)
+{
+	(f(std::get<integers>(t), reader->template GetVec<start + integers>(), start + integers), ...);
+}
+
+// Function F arguments are: (inner data tuple element reference, wrapped state data vector, index)
+template<int start, int end, class Reader, class Tuple, typename Function>
+void ReadState(Reader const* reader, Tuple& t, const Function& f)
+{
+	ReadStateHelper<start>(reader, t, f, std::make_integer_sequence<int, detail::abs(start) + end>{});
+}
+
 // Compile-time for loop helper
 template<int start, bool oneshots, class Reader, typename Function, int... integers>
 void NextStateHelper(Reader const* reader, const Function& f, std::integer_sequence<int, integers...>&&)
@@ -409,15 +510,60 @@ public:
 	template<int oneshot_data_index> using get_oneshot_data_t = std::tuple_element_t<oneshot_data_index + State::kOneShotCommonCount, OneShotData>;
 	template<int oneshot_data_index> using get_oneshot_data_wrapped_t = std::tuple_element_t<oneshot_data_index + State::kOneShotCommonCount, OneShotDataWrapped>;
 
-	using Deltas = std::array<bool, State::kCommonCount + State::kUpperBound>;
-	using OneShotDeltas = std::array<bool, State::kOneShotCommonCount + State::kOneShotUpperBound>;
+	using Deltas = std::bitset<State::kCommonCount + State::kUpperBound>;
+	using OneShotDeltas = std::bitset<State::kOneShotCommonCount + State::kOneShotUpperBound>;
+	using Indexes = std::array<int, State::kCommonCount + State::kUpperBound>;
+	using OneShotIndexes = std::array<int, State::kOneShotCommonCount + State::kOneShotUpperBound>;
+
+	// A snapshot of the read position at the start of an order
+	struct Checkpoint
+	{
+		Indexes indexes; // State data vector indexes at the checkpoint's position
+		OneShotIndexes oneshot_indexes; // One-shot data vector indexes just before the checkpoint's position
+		StateData data; // State data at the checkpoint's position
+	};
+
+	// Checkpoints for orders 0, interval, 2 * interval, ...
+	struct Checkpoints
+	{
+		OrderIndex interval = 0;
+		std::vector<Checkpoint> list;
+	};
 
 	StateReader() { Reset(); }
 	StateReader(State* state) : state_{state} { Reset(); }
 	virtual ~StateReader() = default;
 
-	void AssignState(State const* state) { state_ = state; channel_ = 0; }
-	void AssignState(State const* state, ChannelIndex channel) { state_ = state; channel_ = channel; }
+	void AssignState(State const* state) { state_ = state; channel_ = 0; checkpoints_ = nullptr; cursor_valid_ = false; }
+	void AssignState(State const* state, ChannelIndex channel) { state_ = state; channel_ = channel; checkpoints_ = nullptr; cursor_valid_ = false; }
+
+	// Lets SetReadPos, Seek, and ReadAt start from the nearest checkpoint. They must have been created from the current state data.
+	void SetCheckpoints(const Checkpoints* checkpoints) { checkpoints_ = checkpoints; }
+
+	// Reads through the whole state, recording a checkpoint at the start of every interval-th order. Resets the read position.
+	auto CreateCheckpoints(OrderIndex num_orders, OrderIndex interval) -> Checkpoints
+	{
+		assert(interval > 0);
+		Checkpoints checkpoints;
+		checkpoints.interval = interval;
+		checkpoints_ = nullptr;
+
+		Reset();
+		for (unsigned order = 0; order < num_orders; order += interval)
+		{
+			const OrderRowPosition pos = GetOrderRowPosition(static_cast<OrderIndex>(order), 0);
+			Checkpoint checkpoint;
+			SetReadPos<false>(pos - 1);
+			checkpoint.oneshot_indexes = cur_indexes_oneshot_;
+			SetReadPos<false>(pos);
+			checkpoint.indexes = cur_indexes_;
+			checkpoint.data = Copy();
+			checkpoints.list.push_back(std::move(checkpoint));
+		}
+		Reset();
+
+		return checkpoints;
+	}
 
 	// Set current read position to the beginning of the Module's state data
 	virtual void Reset()
@@ -425,8 +571,9 @@ public:
 		cur_pos_ = 0;
 		cur_indexes_.fill(0);
 		cur_indexes_oneshot_.fill(0);
-		deltas_.fill(false);
-		oneshot_deltas_.fill(false);
+		deltas_.reset();
+		oneshot_deltas_.reset();
+		cursor_valid_ = false;
 	}
 
 	// Get the specified state data vector (state_data_index)
@@ -452,14 +599,14 @@ public:
 		const int vec_index = cur_indexes_[GetIndex(state_data_index)];
 		const auto& vec = GetVec<state_data_index>();
 		assert(!vec.empty() && "The initial state must be set before reading");
-		return vec.at(vec_index).second;
+		return vec.Value(vec_index);
 	}
 
 	// Get the specified state data (state_data_index) at the specified read index (vec_index) within the vector
 	template<int state_data_index>
 	constexpr auto Get(std::size_t vec_index) const -> const get_data_t<state_data_index>&
 	{
-		return GetVec<state_data_index>().at(vec_index).second;
+		return GetVec<state_data_index>().Value(vec_index);
 	}
 
 	// Get the specified one-shot data (oneshot_data_index) at the current read position. Only valid if GetOneShotDelta() returned true.
@@ -468,7 +615,7 @@ public:
 	{
 		const int vec_index = cur_indexes_oneshot_[GetOneShotIndex(oneshot_data_index)];
 		assert(vec_index > 0 && "Only call GetOneShot() if GetOneShotDelta() returned true");
-		return GetOneShotVec<oneshot_data_index>().at(vec_index-1).second;
+		return GetOneShotVec<oneshot_data_index>().Value(vec_index - 1);
 	}
 
 	// Gets the specified state data (state_data_index) if it is exactly at the current read position.
@@ -480,10 +627,9 @@ public:
 		assert(!vec.empty() && "The initial state must be set before reading");
 
 		const int vec_index = cur_indexes_[GetIndex(state_data_index)];
-		const auto& elem = vec.at(vec_index);
-		if (elem.first != cur_pos_) { return std::nullopt; }
+		if (vec.Position(vec_index) != cur_pos_) { return std::nullopt; }
 
-		return elem.second;
+		return vec.Value(vec_index);
 	}
 
 	// Returns a tuple of all the state values at the current read position
@@ -501,26 +647,61 @@ public:
 	 * It can also be used to seek forward to the specified position even if it's not the next row.
 	 * If set_deltas == true, sets an array of bools specifying which state values have changed since last iteration.
 	 * These delta values can then be obtained by calling GetDeltas() or GetOneShotDeltas().
+	 * Only the data types whose next element is at or before pos are visited, so rows where nothing changes are cheap.
 	 */
 	template<bool set_deltas = true>
 	void SetReadPos(OrderRowPosition pos)
 	{
+		const OrderRowPosition prev_pos = cur_pos_;
 		cur_pos_ = pos;
 		if constexpr (set_deltas)
 		{
-			deltas_.fill(false);
-			oneshot_deltas_.fill(false);
+			deltas_.reset();
+			oneshot_deltas_.reset();
 		}
 
+		// Skip ahead to the nearest checkpoint if one was passed
+		if (const Checkpoint* checkpoint = GetCheckpoint(pos); checkpoint && CheckpointPosition(checkpoint) > prev_pos)
+		{
+			for (std::size_t i = 0; i < cur_indexes_.size(); ++i)
+			{
+				if (checkpoint->indexes[i] <= cur_indexes_[i]) { continue; }
+				cur_indexes_[i] = checkpoint->indexes[i];
+				if constexpr (set_deltas) { deltas_[i] = true; }
+			}
+			for (std::size_t i = 0; i < cur_indexes_oneshot_.size(); ++i)
+			{
+				// One-shot data before the checkpoint's position can't be at the read position, so there are no deltas
+				cur_indexes_oneshot_[i] = std::max(cur_indexes_oneshot_[i], checkpoint->oneshot_indexes[i]);
+			}
+			cursor_valid_ = false;
+		}
+
+		// Nothing changes until next_change_pos_
+		if (cursor_valid_ && pos < next_change_pos_) { return; }
+
+		// If the cursor is invalid, every data type must be visited to rebuild it
+		const bool visit_all = !cursor_valid_;
+		next_change_pos_ = kNoChange;
+		cursor_valid_ = true;
+
 		detail::NextState<State::kLowerBound, State::kUpperBound, false>(this, [&, this](const auto& vec, int state_data_index)
 		{
+			OrderRowPosition& next_pos = next_pos_[GetIndex(state_data_index)];
+			if (!visit_all && pos < next_pos)
+			{
+				next_change_pos_ = std::min(next_change_pos_, next_pos);
+				return;
+			}
+
 			const int vec_size = static_cast<int>(vec.size());
+			next_pos = kNoChange;
 			if (vec_size == 0) { return; } // No state data for data type state_data_index
 
 			int& index = cur_indexes_[GetIndex(state_data_index)]; // Current index within state data
 
 			// While there's a next state that we need to advance to
-			while (index + 1 != vec_size && cur_pos_ >= vec.at(index + 1).first)
+			while (index + 1 != vec_size && cur_pos_ >= vec.Position(index + 1))
 			{
 				// Need to advance
 				++index;
@@ -531,23 +712,34 @@ public:
 					deltas_[GetIndex(state_data_index)] = true;
 				}
 			}
+
+			if (index + 1 != vec_size) { next_pos = vec.Position(index + 1); }
+			next_change_pos_ = std::min(next_change_pos_, next_pos);
 		});
 
 		detail::NextState<State::kOneShotLowerBound, State::kOneShotUpperBound, true>(this, [&, this](const auto& vec, int oneshot_data_index)
 		{
+			OrderRowPosition& next_pos = next_oneshot_pos_[GetOneShotIndex(oneshot_data_index)];
+			if (!visit_all && pos < next_pos)
+			{
+				next_change_pos_ = std::min(next_change_pos_, next_pos);
+				return;
+			}
+
 			const int vec_size = static_cast<int>(vec.size());
+			next_pos = kNoChange;
 			if (vec_size == 0) { return; } // No one-shot data for data type oneshot_data_index
 
 			int& index = cur_indexes_oneshot_[GetOneShotIndex(oneshot_data_index)]; // Current index within one-shot data
 			if (index == vec_size) { return; }
 
 			// While we need to advance the state
-			while (cur_pos_ >= vec.at(index).first)
+			while (cur_pos_ >= vec.Position(index))
 			{
 				if constexpr (set_deltas)
 				{
 					// If we've reached the position of the current one-shot data
-					if (cur_pos_ == vec.at(index).first)
+					if (cur_pos_ == vec.Position(index))
 					{
 						oneshot_deltas_[GetOneShotIndex(oneshot_data_index)] = true;
 					}
@@ -559,6 +751,9 @@ public:
 				// Break if there is no more one-shot data left to read
 				if (index == vec_size) { break; }
 			}
+
+			if (index != vec_size) { next_pos = vec.Position(index); }
+			next_change_pos_ = std::min(next_change_pos_, next_pos);
 		});
 	}
 
@@ -575,30 +770,52 @@ public:
 		SetReadPos<set_deltas>(GetOrderRowPosition(order, row));
 	}
 
-	// Returns state data at given position, then restores position to what it was previously
-	auto ReadAt(OrderRowPosition pos) -> StateData
+	/*
+	 * Moves the read position directly to pos, forwards or backwards, using a binary search of each state data
+	 * and one-shot data vector. Afterwards, reading works the same as after Reset() followed by SetReadPos(pos),
+	 * except that no deltas are set.
+	 */
+	void Seek(OrderRowPosition pos)
 	{
-		const OrderRowPosition cur_pos_temp = cur_pos_;
-		const auto deltas_temp = deltas_;
-		const auto oneshot_deltas_temp = oneshot_deltas_;
-		const auto cur_indexes_temp = cur_indexes_;
-		const auto cur_indexes_oneshot_temp = cur_indexes_oneshot_;
+		cur_pos_ = pos;
+		deltas_.reset();
+		oneshot_deltas_.reset();
+		cursor_valid_ = false;
 
-		Reset();
-		SetReadPos(pos);
-		auto state_data = Copy();
+		// Only the data after the nearest checkpoint needs to be searched
+		const Checkpoint* checkpoint = GetCheckpoint(pos);
+
+		detail::NextState<State::kLowerBound, State::kUpperBound, false>(this, [&, this](const auto& vec, int state_data_index)
+		{
+			const int index = GetIndex(state_data_index);
+			cur_indexes_[index] = FindIndex(vec, cur_pos_, checkpoint ? checkpoint->indexes[index] : 0);
+		});
+
+		detail::NextState<State::kOneShotLowerBound, State::kOneShotUpperBound, true>(this, [&, this](const auto& vec, int oneshot_data_index)
+		{
+			// The one-shot index is one past the last one-shot data at or before the read position
+			const int index = GetOneShotIndex(oneshot_data_index);
+			cur_indexes_oneshot_[index] = CountUpTo(vec, cur_pos_, checkpoint ? checkpoint->oneshot_indexes[index] : 0);
+		});
+	}
 
-		cur_pos_ = cur_pos_temp;
-		deltas_ = deltas_temp;
-		oneshot_deltas_ = oneshot_deltas_temp;
-		cur_indexes_ = cur_indexes_temp;
-		cur_indexes_oneshot_ = cur_indexes_oneshot_temp;
+	// Returns state data at given position without changing the read position. Uses a binary search of each state data vector.
+	auto ReadAt(OrderRowPosition pos) const -> StateData
+	{
+		const Checkpoint* checkpoint = GetCheckpoint(pos);
+		if (checkpoint && CheckpointPosition(checkpoint) == pos) { return checkpoint->data; }
 
-		return state_data;
+		StateData return_val;
+		detail::ReadState<State::kLowerBound, State::kUpperBound>(this, return_val,
+			[pos, checkpoint, this](auto& return_val_elem, const auto& vec, int state_data_index) {
+				assert(!vec.empty() && "The initial state must be set before reading");
+				return_val_elem = vec.Value(FindIndex(vec, pos, checkpoint ? checkpoint->indexes[GetIndex(state_data_index)] : 0));
+			});
+		return return_val;
 	}
 
-	// Returns state data at given position, then restores position to what it was previously
-	auto ReadAt(OrderIndex order, RowIndex row) -> StateData
+	// Returns state data at given position without changing the read position
+	auto ReadAt(OrderIndex order, RowIndex row) const -> StateData
 	{
 		return ReadAt(GetOrderRowPosition(order, row));
 	}
@@ -613,12 +830,12 @@ public:
 	// Returns the deltas from the last SetReadPos<true>() call
 	constexpr auto GetDeltas() const -> const Deltas& { return deltas_; }
 
-	constexpr auto GetDelta(int state_data_index) const -> bool { return deltas_[GetIndex(state_data_index)]; }
+	auto GetDelta(int state_data_index) const -> bool { return deltas_[GetIndex(state_data_index)]; }
 
 	// Returns the one-shot deltas from the last SetReadPos<true>() call
 	constexpr auto GetOneShotDeltas() const -> const OneShotDeltas& { return oneshot_deltas_; }
 
-	constexpr auto GetOneShotDelta(int oneshot_data_index) const -> bool
+	auto GetOneShotDelta(int oneshot_data_index) const -> bool
 	{
 		return oneshot_deltas_[GetOneShotIndex(oneshot_data_index)];
 	}
@@ -643,8 +860,7 @@ public:
 		int vec_index = cur_indexes_[GetIndex(state_data_index)];
 		for (; vec_index < static_cast<int>(vec.size()); ++vec_index)
 		{
-			const auto& elem = vec.at(vec_index);
-			if (cmp(elem.second)) { return elem; }
+			if (cmp(vec.Value(vec_index))) { return std::pair{vec.Position(vec_index), vec.Value(vec_index)}; }
 		}
 
 		return std::nullopt;
@@ -652,6 +868,51 @@ public:
 
 protected:
 
+	// Returns the number of elements of vec at or before pos: the one-shot data index SetReadPos(pos) would reach after Reset().
+	// Elements before index first are known to be before pos.
+	template<class Vec>
+	auto CountUpTo(const Vec& vec, OrderRowPosition pos, int first = 0) const -> int
+	{
+		if (state_->IsSorted())
+		{
+			return static_cast<int>(vec.UpperBound(pos, first));
+		}
+
+		// Positions are out of order, so only a linear scan matches SetReadPos
+		int index = first;
+		while (index < static_cast<int>(vec.size()) && pos >= vec.Position(index)) { ++index; }
+		return index;
+	}
+
+	// Returns the state data index SetReadPos(pos) would reach after Reset(): the last element of vec at or before pos, or 0 if there isn't one
+	template<class Vec>
+	auto FindIndex(const Vec& vec, OrderRowPosition pos, int first = 0) const -> int
+	{
+		if (state_->IsSorted())
+		{
+			return std::max(CountUpTo(vec, pos, first) - 1, 0);
+		}
+
+		// Positions are out of order, so only a linear scan matches SetReadPos
+		int index = first;
+		while (index + 1 < static_cast<int>(vec.size()) && pos >= vec.Position(index + 1)) { ++index; }
+		return index;
+	}
+
+	// Returns the last checkpoint at or before pos, if there is one
+	auto GetCheckpoint(OrderRowPosition pos) const -> const Checkpoint*
+	{
+		if (!checkpoints_ || checkpoints_->list.empty() || pos < 0) { return nullptr; }
+		const std::size_t checkpoint = GetOrderRowPosition(pos).first / checkpoints_->interval;
+		return &checkpoints_->list[std::min(checkpoint, checkpoints_->list.size() - 1)];
+	}
+
+	auto CheckpointPosition(const Checkpoint* checkpoint) const -> OrderRowPosition
+	{
+		const auto checkpoint_index = static_cast<OrderIndex>(checkpoint - checkpoints_->list.data());
+		return GetOrderRowPosition(static_cast<OrderIndex>(checkpoint_index * checkpoints_->interval), 0);
+	}
+
 	// Converts StateEnumCommon or StateEnum variants into a zero-based index of an array. Returns offset if no enum is provided.
 	static constexpr auto GetIndex(int state_data_index = 0) -> int { return State::kCommonCount + state_data_index; }
 
@@ -659,12 +920,20 @@ protected:
 	static constexpr auto GetOneShotIndex(int oneshot_data_index = 0) -> int { return State::kOneShotCommonCount + oneshot_data_index; }
 
 	const State* state_ = nullptr; // The state this reader is reading from
-	Deltas deltas_; // An array of bools indicating which (if any) state data values have changed since the last SetReadPos<true>() call
+	Deltas deltas_; // A bitset indicating which (if any) state data values have changed since the last SetReadPos<true>() call
 	OneShotDeltas oneshot_deltas_; // Same as deltas_ but for one-shots
 	OrderRowPosition cur_pos_; // The current read position in terms of order and pattern row. (The write position is the end of the state data vector)
-	std::array<int, State::kCommonCount + State::kUpperBound> cur_indexes_; // array of state data vector indexes
-	std::array<int, State::kOneShotCommonCount + State::kOneShotUpperBound> cur_indexes_oneshot_; // array of one-shot data vector indexes
+	Indexes cur_indexes_; // array of state data vector indexes
+	OneShotIndexes cur_indexes_oneshot_; // array of one-shot data vector indexes
 	ChannelIndex channel_; // Which channel this reader is used for (if applicable)
+	const Checkpoints* checkpoints_ = nullptr; // Optional; speeds up seeking
+
+	// Next-change cursor used by SetReadPos. Invalidated by anything which moves the indexes or changes the state data.
+	static constexpr OrderRowPosition kNoChange = std::numeric_limits<OrderRowPosition>::max();
+	std::array<OrderRowPosition, State::kCommonCount + State::kUpperBound> next_pos_; // Position of the next element of each state data vector
+	std::array<OrderRowPosition, State::kOneShotCommonCount + State::kOneShotUpperBound> next_oneshot_pos_; // Position of the next unread element of each one-shot data vector
+	OrderRowPosition next_change_pos_ = kNoChange; // The minimum of next_pos_ and next_oneshot_pos_
+	bool cursor_valid_ = false;
 };
 
 // Type aliases for convenience
@@ -730,7 +999,8 @@ public:
 		assert(state_write_);
 		auto& vec = state_write_->template Get<state_data_index>();
 		assert(vec.empty());
-		vec.push_back({R::cur_pos_, std::move(val)});
+		vec.PushBack(R::cur_pos_, std::move(val));
+		R::cursor_valid_ = false;
 	}
 
 	// Set the initial state
@@ -748,28 +1018,31 @@ public:
 		assert(state_write_);
 		auto& vec = state_write_->template Get<state_data_index>();
 		assert(!vec.empty() && "Use SetInitial() to set the initial state before using Set()");
-		auto& vec_elem = vec.back(); // Current vec element (always the end when writing)
+		const std::size_t last = vec.size() - 1; // Current vec element (always the end when writing)
 
 		// There can only be one state data value for a given OrderRowPosition, so we won't always be adding a new element to the vector
-		if (vec_elem.first != R::cur_pos_)
+		if (vec.Position(last) != R::cur_pos_)
 		{
 			if constexpr (!ignore_duplicates)
 			{
 				// If the latest value in the state is the same
 				// as what we're trying to add to the state, don't add it
-				if (vec_elem.second == val) { return; }
+				if (vec.Value(last) == val) { return; }
 			}
 
+			if (R::cur_pos_ < vec.Position(last)) { state_write_->SetUnsorted(); }
+
 			// Add new element
-			vec.push_back({R::cur_pos_, std::move(val)});
+			vec.PushBack(R::cur_pos_, std::move(val));
 
 			// Adjust current index
 			int& index = R::cur_indexes_[R::GetIndex(state_data_index)]; // Current index within state data for this data type
 			++index;
+			R::cursor_valid_ = false;
 		}
 		else
 		{
-			vec_elem.second = std::move(val); // Update current element
+			vec.Value(last) = std::move(val); // Update current element
 		}
 	}
 
@@ -792,29 +1065,33 @@ public:
 		if (vec.empty())
 		{
 			// Add new element
-			vec.push_back({R::cur_pos_, std::move(val)});
+			vec.PushBack(R::cur_pos_, std::move(val));
 
 			// Adjust current index
 			int& index = R::cur_indexes_oneshot_[R::GetOneShotIndex(oneshot_data_index)]; // Current index within one-shot data for this data type
 			++index;
+			R::cursor_valid_ = false;
 			return;
 		}
 
-		auto& vec_elem = vec.back(); // Current vec element (always the end when writing)
+		const std::size_t last = vec.size() - 1; // Current vec element (always the end when writing)
 
 		// There can only be one one-shot data value for a given OrderRowPosition, so we won't always be adding a new element to the vector
-		if (vec_elem.first != R::cur_pos_)
+		if (vec.Position(last) != R::cur_pos_)
 		{
+			if (R::cur_pos_ < vec.Position(last)) { state_write_->SetUnsorted(); }
+
 			// Add new element
-			vec.push_back({R::cur_pos_, std::move(val)});
+			vec.PushBack(R::cur_pos_, std::move(val));
 
 			// Adjust current index
 			int& index = R::cur_indexes_oneshot_[R::GetOneShotIndex(oneshot_data_index)]; // Current index within one-shot data for this data type
 			++index;
+			R::cursor_valid_ = false;
 		}
 		else
 		{
-			vec_elem.second = std::move(val); // Update current element
+			vec.Value(last) = std::move(val); // Update current element
 		}
 	}
 
@@ -841,14 +1118,13 @@ public:
 		auto& vec = state_write_->template Get<state_data_index>();
 		assert(!vec.empty() && "The initial state must be set before reading");
 		const int vec_index = R::cur_indexes_[R::GetIndex(state_data_index)];
-		auto& vec_elem = vec[vec_index];
 
-		if (R::cur_pos_ == vec_elem.first)
+		if (R::cur_pos_ == vec.Position(vec_index))
 		{
 			// There's already an element at the position we want to insert val
 			if constexpr (overwrite)
 			{
-				vec_elem.second = val;
+				vec.Value(vec_index) = val;
 				Reset();
 				return false;
 			}
@@ -856,9 +1132,10 @@ public:
 			return true; // Failure
 		}
 
-		// pos > vec_elem.first
-		const auto iter_after = vec.begin() + vec_index + 1;
-		vec.insert(iter_after, std::pair{R::cur_pos_, val});
+		// pos > vec.Position(vec_index)
+		const std::size_t index_after = vec_index + 1;
+		if (index_after != vec.size() && vec.Position(index_after) < R::cur_pos_) { state_write_->SetUnsorted(); }
+		vec.Insert(index_after, R::cur_pos_, val);
 		Reset();
 		return false;
 	}
@@ -867,9 +1144,7 @@ public:
 	template<int state_data_index, bool overwrite = false>
 	auto Insert(OrderRowPosition pos, const get_data_t<state_data_index>& val) -> bool
 	{
-		Reset();
-		R::SetReadPos(pos);
-		SetWritePos(pos);
+		R::Seek(pos);
 		return Insert<state_data_index, overwrite>(val);
 	}
 
@@ -969,20 +1244,49 @@ public:
 	{
 		auto return_val = StateReaders<ModuleClass>{};
 		return_val.global_reader.AssignState(&global_state_);
+		return_val.global_reader.SetCheckpoints(&global_checkpoints_);
 		return_val.channel_readers.resize(channel_states_.size());
 		for (unsigned i = 0; i < channel_states_.size(); ++i)
 		{
 			return_val.channel_readers[i].AssignState(&channel_states_[i], i);
+			if (i < channel_checkpoints_.size()) { return_val.channel_readers[i].SetCheckpoints(&channel_checkpoints_[i]); }
 		}
 		return return_val;
 	}
 
+	auto GetCheckpointInterval() const -> OrderIndex { return global_checkpoints_.interval; }
+
 private:
 
 	// Only the ModuleClass which this class stores state information for is allowed to write state data
 	friend ModuleClass;
 
-	void Initialize(unsigned numChannels) { channel_states_.resize(numChannels); }
+	void Initialize(unsigned numChannels)
+	{
+		channel_states_.resize(numChannels);
+		global_checkpoints_ = {};
+		channel_checkpoints_.clear();
+	}
+
+	/*
+	 * Records a snapshot of the global and per-channel state at the start of every interval-th order.
+	 * Readers from GetReaders() use them to seek without reading from the start of the song.
+	 * Call this once all state data has been written.
+	 */
+	void CreateCheckpoints(OrderIndex num_orders, OrderIndex interval = kDefaultCheckpointInterval)
+	{
+		GlobalStateReader<ModuleClass> global_reader;
+		global_reader.AssignState(&global_state_);
+		global_checkpoints_ = global_reader.CreateCheckpoints(num_orders, interval);
+
+		channel_checkpoints_.resize(channel_states_.size());
+		ChannelStateReader<ModuleClass> channel_reader;
+		for (unsigned i = 0; i < channel_states_.size(); ++i)
+		{
+			channel_reader.AssignState(&channel_states_[i], i);
+			channel_checkpoints_[i] = channel_reader.CreateCheckpoints(num_orders, interval);
+		}
+	}
 
 	//! Creates and returns a pointer to a StateReaderWriters object. The reader/writers are valid only for as long as ModuleState is valid.
 	auto GetReaderWriters() -> StateReaderWriters<ModuleClass>
@@ -998,8 +1302,13 @@ private:
 	}
 
 private:
+	static constexpr OrderIndex kDefaultCheckpointInterval = 4;
+
 	GlobalState<ModuleClass> global_state_;
 	std::vector<ChannelState<ModuleClass>> channel_states_;
+
+	typename GlobalStateReader<ModuleClass>::Checkpoints global_checkpoints_;
+	std::vector<typename ChannelStateReader<ModuleClass>::Checkpoints> channel_checkpoints_;
 };
 
 } // namespace d2m
@@ -43,7 +43,8 @@ public:
 	enum class ExportError
 	{
 		kSuccess  = 0,
-		kFileOpen = -1
+		kFileOpen = -1,
+		kWrite    = -2
 	};
 
 	enum class ConvertError
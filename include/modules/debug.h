@@ -71,7 +71,9 @@ private:
 	Debug() = default;
 
 	void ImportImpl(const std::string& filename) override;
+	void ImportImpl(const void* data, std::size_t size) override;
 	void ExportImpl(const std::string& filename) override;
+	void ExportImpl(std::vector<std::byte>& buffer) override;
 	void ConvertImpl(const ModulePtr& input) override;
 	auto GenerateDataImpl(std::size_t data_flags) const -> std::size_t override { return 1; }
 
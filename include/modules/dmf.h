@@ -8,11 +8,14 @@
 #pragma once
 
 #include "core/module.h"
+#include "utils/inflate.h"
 #include "utils/stream_reader.h"
 
 #include <array>
+#include <chrono>
 #include <map>
 #include <string>
+#include <tuple>
 
 namespace d2m {
 
@@ -54,8 +57,15 @@ struct System
 
 } // namespace dmf
 
+// Chosen at build time with the DMF_STORAGE CMake option
+#ifdef DMF2MOD_DMF_COLUMNAR
+inline constexpr DataStorageType kDMFStorageType = DataStorageType::kColumnar;
+#else
+inline constexpr DataStorageType kDMFStorageType = DataStorageType::kPacked;
+#endif
+
 template<>
-struct ModuleGlobalData<DMF> : public ModuleGlobalDataDefault<DataStorageType::kCOR>
+struct ModuleGlobalData<DMF> : public ModuleGlobalDataDefault<kDMFStorageType>
 {
 	std::uint8_t dmf_format_version;
 	dmf::System system;
@@ -79,12 +89,48 @@ struct Row<DMF>
 	std::int16_t instrument;
 };
 
+// Lets DMF data use DataStorageType::kColumnar: each effects column gets its own array
+template<>
+struct RowColumns<DMF>
+{
+	enum Column { kNote, kVolume, kInstrument, kEffect0, kEffect1, kEffect2, kEffect3 };
+
+	using Types = std::tuple<NoteSlot, std::int16_t, std::int16_t, Effect, Effect, Effect, Effect>;
+
+	static auto Split(const Row<DMF>& row) -> Types
+	{
+		return {row.note, row.volume, row.instrument, row.effect[0], row.effect[1], row.effect[2], row.effect[3]};
+	}
+
+	static auto Join(const Types& columns) -> Row<DMF>
+	{
+		const auto& [note, volume, instrument, effect0, effect1, effect2, effect3] = columns;
+		return {note, volume, {effect0, effect1, effect2, effect3}, instrument};
+	}
+};
+
 template<>
 struct ChannelMetadata<DMF>
 {
 	std::uint8_t effect_columns_count;
 };
 
+/*
+ * Packed DMF rows: note (1 byte), volume (2), instrument (2), then (code (1), value (2)) for
+ * each of the channel's effects columns. Unused effects columns are not stored at all.
+ */
+template<>
+struct RowPacking<DMF>
+{
+	static auto GetPackedSize(const ChannelMetadata<DMF>& metadata) -> std::size_t;
+	static void Pack(const Row<DMF>& row, const ChannelMetadata<DMF>& metadata, std::byte* out);
+	static auto Unpack(const std::byte* in, const ChannelMetadata<DMF>& metadata) -> Row<DMF>;
+
+	// Reads only effects column col (less than GetEffectColumns(metadata)) of a packed row, without unpacking the rest
+	static auto GetEffectColumns(const ChannelMetadata<DMF>& metadata) -> std::size_t;
+	static auto GetEffect(const std::byte* in, std::size_t col) -> Effect;
+};
+
 template<>
 struct PatternMetadata<DMF>
 {
@@ -144,6 +190,17 @@ struct ModuleInfo
 	std::uint8_t time_base, tick_time1, tick_time2;
 };
 
+// Basic information about a DMF file which DMF::Probe reads without importing the module
+struct Metadata
+{
+	std::string title;
+	std::string author;
+	System system;
+	std::uint8_t dmf_format_version;
+	OrderIndex num_orders;
+	RowIndex num_rows;
+};
+
 struct FMOps
 {
 	// TODO: Use unions depending on DMF version?
@@ -229,6 +286,25 @@ struct Instrument
 	};
 };
 
+// Byte offsets into the inflated DMF file where each section begins, recorded during import
+struct SectionOffsets
+{
+	std::size_t pattern_matrix;
+	std::size_t instruments;
+	std::size_t wavetables;
+	std::size_t patterns;
+	std::size_t pcm_samples;
+};
+
+// Time spent in each stage of the last import, for finding which stage is the bottleneck
+struct ImportTimings
+{
+	std::chrono::nanoseconds inflate;       // Inflating compressed data. In streaming mode this is counted in parse instead.
+	std::chrono::nanoseconds parse;         // Parsing the inflated data, not counting parse_stall
+	std::chrono::nanoseconds inflate_stall; // Pipelined mode only: inflater blocked on a full chunk queue (parsing is slower)
+	std::chrono::nanoseconds parse_stall;   // Pipelined mode only: parser blocked on an empty chunk queue (inflating is slower)
+};
+
 struct PCMSample
 {
 	std::uint32_t size;
@@ -283,9 +359,49 @@ public:
 
 	using SystemType = dmf::System::Type;
 
+	// How the DMF file is read during import
+	enum class ImportMode
+	{
+		kBuffered, // Inflate the whole file into one contiguous buffer first, then parse it from memory
+		kStreaming, // Inflate and parse the file incrementally
+		kPipelined  // Inflate the file into chunks on a separate thread while parsing the chunks already inflated
+	};
+
+	// Which sections of the DMF file are decoded during import
+	enum class ImportProfile
+	{
+		kAuto,    // Decide using the conversion target (see ModuleBase::SetConversionTarget)
+		kFull,    // Decode everything
+		kPatterns // Skip over instruments and PCM sample data; PCM sample names and sizes are still loaded
+	};
+
 	// Factory requires destructor to be public
 	~DMF() override;
 
+	void SetImportMode(ImportMode mode) { import_mode_ = mode; }
+	auto GetImportMode() const -> ImportMode { return import_mode_; }
+
+	// Which zlib inflate backend buffered import uses. Defaults to the one chosen at build time.
+	void SetInflateBackend(InflateBackend backend) { inflate_backend_ = backend; }
+	auto GetInflateBackend() const -> InflateBackend { return inflate_backend_; }
+
+	void SetImportProfile(ImportProfile profile) { import_profile_ = profile; }
+	auto GetImportProfile() const -> ImportProfile { return import_profile_; }
+
+	// Where each section began in the last imported DMF file
+	auto GetSectionOffsets() const -> const dmf::SectionOffsets& { return section_offsets_; }
+
+	// How long each stage of the last import took
+	auto GetImportTimings() const -> const dmf::ImportTimings& { return import_timings_; }
+
+	/*
+	 * Reads only the start of a DMF file to get its metadata, without importing the module.
+	 * Only the beginning of the compressed data is inflated.
+	 * Throws ModuleException upon failure
+	 */
+	static auto Probe(const std::string& filename) -> dmf::Metadata;
+	static auto Probe(const void* data, std::size_t size) -> dmf::Metadata;
+
 	// Returns the initial BPM of the module
 	void GetBPM(unsigned& numerator, unsigned& denominator) const;
 	auto GetBPM() const -> double;
@@ -306,12 +422,30 @@ private:
 	void CleanUp();
 
 	void ImportImpl(const std::string& filename) override;
+	void ImportImpl(const void* data, std::size_t size) override;
 	void ExportImpl(const std::string& filename) override;
+	void ExportImpl(std::vector<std::byte>& buffer) override;
 	void ConvertImpl(const ModulePtr& input) override;
 	auto GenerateDataImpl(std::size_t data_flags) const -> std::size_t override;
 
+	// Each import mode, given a compressed or uncompressed DMF file
+	void ImportBuffered(const void* data, std::size_t size);
+	void ImportStreaming(std::streambuf& source);
+	auto ImportPipelined(std::streambuf& source) -> bool; // Returns false without reading anything if a thread can't be started
+
+	static auto ProbeFromSource(std::streambuf& source) -> dmf::Metadata;
+
+	// Resolves ImportProfile::kAuto
+	auto GetEffectiveImportProfile() const -> ImportProfile;
+
 	// Import helper class
-	class Importer;
+	template<class Reader> class Importer;
+
+	ImportMode import_mode_ = ImportMode::kBuffered;
+	ImportProfile import_profile_ = ImportProfile::kAuto;
+	InflateBackend inflate_backend_ = kDefaultInflateBackend;
+	dmf::SectionOffsets section_offsets_{};
+	dmf::ImportTimings import_timings_{};
 
 	dmf::ModuleInfo module_info_; // TODO: Eventually remove
 	std::uint8_t total_instruments_ = 0;
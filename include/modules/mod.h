@@ -10,9 +10,11 @@
 #include "core/module.h"
 
 #include <array>
+#include <cstddef>
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace d2m {
 
@@ -148,7 +150,8 @@ public:
 		kNotGameBoy,
 		kTooManyPatternMatrixRows,
 		kOver64RowPattern,
-		kWrongChannelCount
+		kWrongChannelCount,
+		kTooManySamples
 	};
 
 	enum class ConvertWarning
@@ -176,19 +179,24 @@ private:
 
 	// Module requirements:
 	void ImportImpl(const std::string& filename) override;
+	void ImportImpl(const void* data, std::size_t size) override;
 	void ExportImpl(const std::string& filename) override;
+	void ExportImpl(std::vector<std::byte>& buffer) override;
 	void ConvertImpl(const ModulePtr& input) override;
 	auto GenerateDataImpl(std::size_t data_flags) const -> std::size_t override { return 1; }
 
 	// DMF -> MOD conversion
 	class DMFConverter;
 
-	// Export helpers:
-	void ExportModuleName(std::ofstream& fout) const;
-	void ExportSampleInfo(std::ofstream& fout) const;
-	void ExportModuleInfo(std::ofstream& fout) const;
-	void ExportPatterns(std::ofstream& fout) const;
-	void ExportSampleData(std::ofstream& fout) const;
+	// Exact size of the exported MOD file
+	auto GetExportSize() const -> std::size_t;
+
+	// Export helpers (each writes its section at out, then advances out past it):
+	void ExportModuleName(std::byte*& out) const;
+	void ExportSampleInfo(std::byte*& out) const;
+	void ExportModuleInfo(std::byte*& out) const;
+	void ExportPatterns(std::byte*& out) const;
+	void ExportSampleData(std::byte*& out) const;
 
 	// MOD file info:
 	std::int8_t total_mod_samples_;
@@ -0,0 +1,160 @@
+/*
+ * buffer_reader.h
+ * Written by Dalton Messmer <messmer.dalton@gmail.com>.
+ *
+ * Defines a header-only zero-copy reader for contiguous in-memory buffers
+ * which provides the same methods as StreamReader
+ */
+
+#pragma once
+
+#include "utils/stream_reader.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace d2m {
+
+/*
+ * Cursor over a contiguous buffer owned by the caller. Integers are decoded
+ * with plain loads instead of per-byte virtual streambuf calls.
+ * Like an istream, reading past the end of the buffer does not throw: the
+ * missing bytes read as zeros and Overran() returns true afterwards.
+ */
+template<Endianness global_endian = Endianness::kUnspecified>
+class BufferReader
+{
+private:
+	const char* begin_ = nullptr;
+	const char* cur_ = nullptr;
+	const char* end_ = nullptr;
+	bool overran_ = false;
+
+	// Returns a pointer to the next length bytes and moves past them, or nullptr if there aren't enough left
+	auto Advance(std::size_t length) -> const char*
+	{
+		if (length > Remaining())
+		{
+			cur_ = end_;
+			overran_ = true;
+			return nullptr;
+		}
+
+		const char* ptr = cur_;
+		cur_ += length;
+		return ptr;
+	}
+
+public:
+	BufferReader() = default;
+	BufferReader(const void* data, std::size_t size)
+		: begin_{static_cast<const char*>(data)}, cur_{begin_}, end_{begin_ + size} {}
+
+	auto GetPos() const -> std::size_t { return static_cast<std::size_t>(cur_ - begin_); }
+	auto Remaining() const -> std::size_t { return static_cast<std::size_t>(end_ - cur_); }
+	auto Overran() const -> bool { return overran_; }
+
+	// Pointer to the next unread byte. Remaining() bytes may be read from it.
+	auto Data() const -> const char* { return cur_; }
+
+	auto ReadStr(unsigned length) -> std::string
+	{
+		const char* ptr = Advance(length);
+		return ptr ? std::string(ptr, length) : std::string(length, '\0');
+	}
+
+	auto ReadPStr() -> std::string
+	{
+		// P-Strings (Pascal strings) are prefixed with a 1 byte length
+		const std::uint8_t string_length = ReadInt();
+		return ReadStr(string_length);
+	}
+
+	auto ReadBytes(unsigned length) -> std::vector<char>
+	{
+		const char* ptr = Advance(length);
+		return ptr ? std::vector<char>(ptr, ptr + length) : std::vector<char>(length, '\0');
+	}
+
+	// Moves forward length bytes without reading them
+	void Skip(std::size_t length)
+	{
+		Advance(length);
+	}
+
+	template<bool is_signed = false, std::uint8_t num_bytes = 1, Endianness endian = global_endian>
+	auto ReadInt()
+	{
+		using UIntType = std::conditional_t<(num_bytes > 1), detail::UIntSelector<num_bytes>, std::uint8_t>;
+		using ReturnType = std::conditional_t<is_signed, std::make_signed_t<UIntType>, UIntType>;
+
+		static_assert(num_bytes <= 8 && num_bytes >= 1, "Accepted range for num_bytes: 1 <= num_bytes <= 8");
+		static_assert(num_bytes == 1 || endian != Endianness::kUnspecified, "Set the endianness when creating BufferReader or set it in this method's template parameters");
+
+		const auto* bytes = reinterpret_cast<const unsigned char*>(Advance(num_bytes));
+		if (!bytes) { return ReturnType{0}; }
+
+		UIntType value{};
+		if constexpr (num_bytes == sizeof(UIntType))
+		{
+			std::memcpy(&value, bytes, num_bytes);
+			if constexpr (num_bytes > 1 && endian != kHostEndianness)
+			{
+				value = detail::ByteSwap(value);
+			}
+			return static_cast<ReturnType>(value);
+		}
+		else
+		{
+			// Odd sizes such as 3 bytes
+			for (std::uint8_t i = 0; i < num_bytes; ++i)
+			{
+				const std::uint8_t shift = endian == Endianness::kLittle ? i * 8 : (num_bytes - 1 - i) * 8;
+				value |= static_cast<UIntType>(bytes[i]) << shift;
+			}
+
+			if constexpr (is_signed)
+			{
+				constexpr unsigned kUnusedBits = (sizeof(UIntType) - num_bytes) * 8;
+				return static_cast<ReturnType>(static_cast<ReturnType>(value << kUnusedBits) >> kUnusedBits);
+			}
+			else
+			{
+				return static_cast<ReturnType>(value);
+			}
+		}
+	}
+
+	/*
+	 * Copies an array of count integers of type T into dest, then fixes the byte order if needed.
+	 * If the buffer ends early, the bytes which are available are still copied and the rest read as zeros,
+	 * the same as StreamReader::ReadInts.
+	 */
+	template<typename T, Endianness endian = global_endian>
+	void ReadInts(T* dest, std::size_t count)
+	{
+		static_assert(std::is_integral_v<T>);
+		static_assert(sizeof(T) == 1 || endian != Endianness::kUnspecified, "Set the endianness when creating BufferReader or set it in this method's template parameters");
+
+		auto* bytes = reinterpret_cast<char*>(dest);
+		const auto length = count * sizeof(T);
+		const auto bytes_read = std::min(length, Remaining());
+		const char* ptr = cur_;
+		Advance(length);
+
+		if (bytes_read > 0) { std::memcpy(bytes, ptr, bytes_read); }
+		std::fill(bytes + bytes_read, bytes + length, '\0');
+
+		if constexpr (sizeof(T) > 1 && endian != kHostEndianness)
+		{
+			detail::ByteSwapArray(dest, count);
+		}
+	}
+};
+
+} // namespace d2m
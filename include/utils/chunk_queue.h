@@ -0,0 +1,134 @@
+/*
+ * chunk_queue.h
+ * Written by Dalton Messmer <messmer.dalton@gmail.com>.
+ *
+ * Defines a header-only bounded queue for handing chunks of bytes from a
+ * producer thread to a consumer thread, and a std::streambuf which reads from it
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <streambuf>
+#include <vector>
+
+namespace d2m {
+
+/*
+ * Thread-safe FIFO of byte chunks which holds at most a fixed number of chunks.
+ * One thread pushes chunks and then calls Close(); another thread pops them.
+ * Time spent blocked on either side is recorded so the slower side can be identified.
+ */
+class ChunkQueue
+{
+public:
+	using Chunk = std::vector<char>;
+	using Clock = std::chrono::steady_clock;
+
+	explicit ChunkQueue(std::size_t capacity) : capacity_{capacity > 0 ? capacity : 1} {}
+
+	ChunkQueue(const ChunkQueue&) = delete;
+	auto operator=(const ChunkQueue&) -> ChunkQueue& = delete;
+
+	// Blocks while the queue is full. Returns false without pushing if the queue was cancelled.
+	auto Push(Chunk&& chunk) -> bool
+	{
+		std::unique_lock lock{mutex_};
+		if (chunks_.size() >= capacity_ && !cancelled_)
+		{
+			const auto start = Clock::now();
+			not_full_.wait(lock, [this] { return chunks_.size() < capacity_ || cancelled_; });
+			push_wait_time_ += Clock::now() - start;
+		}
+
+		if (cancelled_) { return false; }
+		chunks_.push_back(std::move(chunk));
+		not_empty_.notify_one();
+		return true;
+	}
+
+	// Blocks while the queue is empty. Returns false once the queue is closed or cancelled and has no chunks left.
+	auto Pop(Chunk& chunk) -> bool
+	{
+		std::unique_lock lock{mutex_};
+		if (chunks_.empty() && !closed_ && !cancelled_)
+		{
+			const auto start = Clock::now();
+			not_empty_.wait(lock, [this] { return !chunks_.empty() || closed_ || cancelled_; });
+			pop_wait_time_ += Clock::now() - start;
+		}
+
+		if (chunks_.empty() || cancelled_) { return false; }
+		chunk = std::move(chunks_.front());
+		chunks_.pop_front();
+		not_full_.notify_one();
+		return true;
+	}
+
+	// Called by the producer after its last chunk
+	void Close()
+	{
+		std::lock_guard lock{mutex_};
+		closed_ = true;
+		not_empty_.notify_all();
+	}
+
+	// Called by either side to stop the other one. Pending and future chunks are dropped.
+	void Cancel()
+	{
+		std::lock_guard lock{mutex_};
+		cancelled_ = true;
+		chunks_.clear();
+		not_full_.notify_all();
+		not_empty_.notify_all();
+	}
+
+	// Total time the producer spent waiting for the consumer to make room
+	auto GetPushWaitTime() const -> Clock::duration { std::lock_guard lock{mutex_}; return push_wait_time_; }
+
+	// Total time the consumer spent waiting for the producer to supply a chunk
+	auto GetPopWaitTime() const -> Clock::duration { std::lock_guard lock{mutex_}; return pop_wait_time_; }
+
+private:
+	const std::size_t capacity_;
+	std::deque<Chunk> chunks_;
+	bool closed_ = false;
+	bool cancelled_ = false;
+	Clock::duration push_wait_time_{};
+	Clock::duration pop_wait_time_{};
+
+	mutable std::mutex mutex_;
+	std::condition_variable not_full_;
+	std::condition_variable not_empty_;
+};
+
+/*
+ * Read-only, non-seekable std::streambuf which pops its data from a ChunkQueue.
+ * Reaches end of file once the queue is closed and drained.
+ */
+class ChunkQueueStreamBuffer : public std::streambuf
+{
+public:
+	explicit ChunkQueueStreamBuffer(ChunkQueue& queue) : queue_{queue} {}
+
+protected:
+	auto underflow() -> int_type override
+	{
+		while (gptr() == egptr())
+		{
+			if (!queue_.Pop(chunk_)) { return traits_type::eof(); }
+			setg(chunk_.data(), chunk_.data(), chunk_.data() + chunk_.size());
+		}
+		return traits_type::to_int_type(*gptr());
+	}
+
+private:
+	ChunkQueue& queue_;
+	ChunkQueue::Chunk chunk_;
+};
+
+} // namespace d2m
@@ -0,0 +1,44 @@
+/*
+ * inflate.h
+ * Written by Dalton Messmer <messmer.dalton@gmail.com>.
+ *
+ * Declares the backends used to decompress zlib data held in memory
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace d2m {
+
+// Ways of inflating a whole zlib stream which is already in memory
+enum class InflateBackend
+{
+	kStreaming, // Read through zstr's std::istream in fixed-size chunks
+	kOneShot    // A single call to zlib's inflate() into a pre-sized buffer, which only grows if the size estimate was too small
+};
+
+// Chosen at build time with the INFLATE_BACKEND CMake option. Can be overridden at run time.
+#ifdef DMF2MOD_INFLATE_STREAMING
+inline constexpr InflateBackend kDefaultInflateBackend = InflateBackend::kStreaming;
+#else
+inline constexpr InflateBackend kDefaultInflateBackend = InflateBackend::kOneShot;
+#endif
+
+class InflateError : public std::runtime_error
+{
+public:
+	explicit InflateError(const std::string& what) : std::runtime_error{what} {}
+};
+
+/*
+ * Inflates zlib or gzip data. Data without either header is returned unchanged, like zstr does.
+ * If the compressed data ends early, whatever could be inflated is returned.
+ * Throws InflateError upon failure
+ */
+auto Inflate(const void* data, std::size_t size, InflateBackend backend = kDefaultInflateBackend) -> std::vector<char>;
+
+} // namespace d2m
@@ -0,0 +1,51 @@
+/*
+ * mapped_file.h
+ * Written by Dalton Messmer <messmer.dalton@gmail.com>.
+ *
+ * Declares MappedFile, which maps a file into memory for reading
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace d2m {
+
+/*
+ * Read-only view of a whole file's contents in memory.
+ * Uses mmap on POSIX systems and a file mapping on Windows. Elsewhere, or if
+ * mapping fails, the file is read into a buffer owned by the MappedFile instead.
+ */
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+	// Returns false upon failure
+	auto Open(const std::string& filename) -> bool;
+	void Close();
+
+	auto IsOpen() const -> bool { return open_; }
+	auto IsMapped() const -> bool { return mapped_; }
+
+	// Null for an empty file
+	auto Data() const -> const void* { return data_; }
+	auto Size() const -> std::size_t { return size_; }
+
+private:
+	auto ReadIntoBuffer(const std::string& filename) -> bool;
+
+	const char* data_ = nullptr;
+	std::size_t size_ = 0;
+	bool open_ = false;
+	bool mapped_ = false;
+	std::vector<char> buffer_; // Only used if the file could not be mapped
+};
+
+} // namespace d2m
@@ -8,8 +8,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <istream>
+#include <streambuf>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -41,10 +44,91 @@ namespace detail {
 				>
 			>
 		>;
+
+	// Reverses the byte order of an unsigned integer. Compilers recognize this loop as a single bswap instruction.
+	template<typename T>
+	constexpr auto ByteSwap(T value) noexcept -> T
+	{
+		static_assert(std::is_unsigned_v<T>);
+		if constexpr (sizeof(T) == 1)
+		{
+			return value;
+		}
+		else
+		{
+			T result{};
+			for (std::size_t i = 0; i < sizeof(T); ++i)
+			{
+				result = static_cast<T>((result << 8) | (value & 0xFF));
+				value >>= 8;
+			}
+			return result;
+		}
+	}
+
+	// Reverses the byte order of every element in an array of integers. This loop is easily vectorized.
+	template<typename T>
+	inline void ByteSwapArray(T* data, std::size_t count) noexcept
+	{
+		using UIntType = std::make_unsigned_t<T>;
+		auto* values = reinterpret_cast<UIntType*>(data);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			values[i] = ByteSwap(values[i]);
+		}
+	}
 } // namespace detail
 
 enum class Endianness { kUnspecified, kLittle, kBig };
 
+// Byte order of the machine dmf2mod is running on
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr Endianness kHostEndianness = Endianness::kBig;
+#else
+inline constexpr Endianness kHostEndianness = Endianness::kLittle; // MSVC only targets little-endian machines
+#endif
+
+/*
+ * Read-only std::streambuf over a contiguous buffer owned by the caller.
+ * The data is not copied, so the buffer must outlive any stream using it.
+ */
+class MemoryStreamBuffer : public std::streambuf
+{
+public:
+	MemoryStreamBuffer(const void* data, std::size_t size)
+	{
+		// std::streambuf's get area is non-const, but nothing here ever writes to it
+		auto begin = const_cast<char*>(static_cast<const char*>(data));
+		setg(begin, begin, begin + size);
+	}
+
+protected:
+	auto seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) -> pos_type override
+	{
+		if (!(which & std::ios_base::in)) { return pos_type(off_type(-1)); }
+
+		off_type base = 0;
+		switch (dir)
+		{
+			case std::ios_base::beg: base = 0; break;
+			case std::ios_base::cur: base = gptr() - eback(); break;
+			case std::ios_base::end: base = egptr() - eback(); break;
+			default: return pos_type(off_type(-1));
+		}
+
+		const off_type pos = base + off;
+		if (pos < 0 || pos > egptr() - eback()) { return pos_type(off_type(-1)); }
+
+		setg(eback(), eback() + pos, egptr());
+		return pos_type(pos);
+	}
+
+	auto seekpos(pos_type pos, std::ios_base::openmode which) -> pos_type override
+	{
+		return seekoff(off_type(pos), std::ios_base::beg, which);
+	}
+};
+
 /*
  * Wrapper for std::istream and derived classes which provides
  * convenient methods for reading strings and integers
@@ -55,6 +139,14 @@ class StreamReader
 {
 private:
 	IStream stream_;
+	std::size_t pos_ = 0; // Bytes requested so far
+
+	// Like BufferReader, bytes past the end of the stream read as zeros
+	static auto GetByte(IStream& stream) -> std::uint8_t
+	{
+		const auto c = stream.get();
+		return c == IStream::traits_type::eof() ? 0 : static_cast<std::uint8_t>(c);
+	}
 
 	template<typename T, std::uint8_t num_bytes>
 	struct LittleEndianReadOperator
@@ -65,7 +157,7 @@ private:
 		void operator()()
 		{
 			value >>= 8;
-			value |= static_cast<T>(stream_.get()) << kShiftAmount;
+			value |= static_cast<T>(GetByte(stream_)) << kShiftAmount;
 		}
 		IStream& stream_;
 		T value{};
@@ -77,7 +169,7 @@ private:
 		void operator()()
 		{
 			value <<= 8;
-			value |= static_cast<T>(stream_.get());
+			value |= static_cast<T>(GetByte(stream_));
 		}
 		IStream& stream_;
 		T value{};
@@ -132,8 +224,12 @@ public:
 	auto stream() const -> const IStream& { return stream_; }
 	auto stream() -> IStream& { return stream_; }
 
+	// Offset from the start of the stream. Tracked here since streams such as zstr's don't support tellg().
+	auto GetPos() const -> std::size_t { return pos_; }
+
 	auto ReadStr(unsigned length) -> std::string
 	{
+		pos_ += length;
 		std::string temp_str;
 		temp_str.assign(length, '\0');
 		stream_.read(&temp_str[0], length);
@@ -143,18 +239,27 @@ public:
 	auto ReadPStr() -> std::string
 	{
 		// P-Strings (Pascal strings) are prefixed with a 1 byte length
-		std::uint8_t string_length = stream_.get();
+		std::uint8_t string_length = GetByte(stream_);
+		++pos_;
 		return ReadStr(string_length);
 	}
 
 	auto ReadBytes(unsigned length) -> std::vector<char>
 	{
+		pos_ += length;
 		std::vector<char> temp_bytes;
 		temp_bytes.assign(length, '\0');
 		stream_.read(&temp_bytes[0], length);
 		return temp_bytes;
 	}
 
+	// Moves forward length bytes without returning them. Works with streams that can't seek, such as zstr's.
+	void Skip(std::size_t length)
+	{
+		pos_ += length;
+		stream_.ignore(static_cast<std::streamsize>(length));
+	}
+
 	template<bool is_signed = false, std::uint8_t num_bytes = 1, Endianness endian = global_endian>
 	auto ReadInt()
 	{
@@ -162,6 +267,7 @@ public:
 		using ReturnType = std::conditional_t<is_signed, std::make_signed_t<UIntType>, UIntType>;
 
 		static_assert(num_bytes <= 8 && num_bytes >= 1, "Accepted range for num_bytes: 1 <= num_bytes <= 8");
+		pos_ += num_bytes;
 		if constexpr (num_bytes > 1)
 		{
 			static_assert(endian != Endianness::kUnspecified, "Set the endianness when creating StreamReader or set it in this method's template parameters");
@@ -178,7 +284,31 @@ public:
 		{
 			// For single-byte reads, the size of the return value is guaranteed
 			// to be 1 byte and setting the signed parameter is unnecessary
-			return static_cast<ReturnType>(stream_.get());
+			return static_cast<ReturnType>(GetByte(stream_));
+		}
+	}
+
+	/*
+	 * Reads an array of count integers of type T into dest with a single read, then fixes the byte order if needed.
+	 * Elements missing from the end of the stream read as zeros.
+	 */
+	template<typename T, Endianness endian = global_endian>
+	void ReadInts(T* dest, std::size_t count)
+	{
+		static_assert(std::is_integral_v<T>);
+		static_assert(sizeof(T) == 1 || endian != Endianness::kUnspecified, "Set the endianness when creating StreamReader or set it in this method's template parameters");
+
+		auto* bytes = reinterpret_cast<char*>(dest);
+		const auto length = count * sizeof(T);
+		pos_ += length;
+		stream_.read(bytes, static_cast<std::streamsize>(length));
+
+		const auto bytes_read = static_cast<std::size_t>(stream_.gcount());
+		std::fill(bytes + bytes_read, bytes + length, '\0');
+
+		if constexpr (sizeof(T) > 1 && endian != kHostEndianness)
+		{
+			detail::ByteSwapArray(dest, count);
 		}
 	}
 };
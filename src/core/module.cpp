@@ -29,6 +29,22 @@ auto ModuleBase::Import(const std::string& filename) -> bool
 	return true;
 }
 
+auto ModuleBase::Import(const void* data, std::size_t size) -> bool
+{
+	status_.Reset(Status::Category::kImport);
+	try
+	{
+		ImportImpl(data, size);
+		return false;
+	}
+	catch (ModuleException& e)
+	{
+		status_.AddError(std::move(e));
+	}
+
+	return true;
+}
+
 auto ModuleBase::Export(const std::string& filename) -> bool
 {
 	status_.Reset(Status::Category::kExport);
@@ -45,6 +61,47 @@ auto ModuleBase::Export(const std::string& filename) -> bool
 	return true;
 }
 
+auto ModuleBase::Export(std::vector<std::byte>& buffer) -> bool
+{
+	status_.Reset(Status::Category::kExport);
+	try
+	{
+		buffer.clear();
+		ExportImpl(buffer);
+		return false;
+	}
+	catch (ModuleException& e)
+	{
+		status_.AddError(std::move(e));
+	}
+
+	return true;
+}
+
+auto ModuleBase::Export(std::ostream& stream) -> bool
+{
+	std::vector<std::byte> buffer;
+	if (Export(buffer)) { return true; }
+
+	stream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+	if (!stream)
+	{
+		status_.AddError(ModuleException(ModuleException::Category::kExport, ModuleException::ExportError::kWrite));
+		return true;
+	}
+
+	return false;
+}
+
+auto ModuleBase::Export(const ExportSink& sink) -> bool
+{
+	std::vector<std::byte> buffer;
+	if (Export(buffer)) { return true; }
+
+	sink(buffer.data(), buffer.size());
+	return false;
+}
+
 auto ModuleBase::Convert(ModuleType type, const ConversionOptionsPtr& options) -> ModulePtr
 {
 	ModuleBase* input = this; // For clarity
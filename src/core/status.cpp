@@ -80,6 +80,7 @@ auto ModuleException::CreateCommonErrorMessage(Category category, int error_code
 			{
 				case ExportError::kSuccess:  return "No error.";
 				case ExportError::kFileOpen: return "Failed to open file for writing.";
+				case ExportError::kWrite:    return "Failed to write module data.";
 				default: break;
 			}
 			break;
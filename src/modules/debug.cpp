@@ -23,6 +23,12 @@ void Debug::ImportImpl(const std::string& filename)
 	throw NotImplementedException{};
 }
 
+void Debug::ImportImpl(const void* data, std::size_t size)
+{
+	// Not implemented
+	throw NotImplementedException{};
+}
+
 void Debug::ConvertImpl(const ModulePtr& input)
 {
 	dump_.clear();
@@ -105,6 +111,12 @@ void Debug::ExportImpl(const std::string& filename)
 	if (verbose) { std::cout << "Wrote log to disk.\n\n"; }
 }
 
+void Debug::ExportImpl(std::vector<std::byte>& buffer)
+{
+	// Not implemented
+	throw NotImplementedException{};
+}
+
 } // namespace d2m
 
 #endif // !NDEBUG
@@ -10,58 +10,155 @@
 
 #include "modules/dmf.h"
 
-#include "utils/hash.h"
+#include "utils/buffer_reader.h"
+#include "utils/chunk_queue.h"
+#include "utils/inflate.h"
+#include "utils/mapped_file.h"
 #include "utils/utils.h"
 
 #include <gcem.hpp>
 #include <zstr.hpp>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <optional>
 #include <string>
-#include <unordered_set>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 namespace d2m {
 
 static constexpr std::uint8_t kDMFFileVersionMin = 17; // DMF files as old as version 17 (0x11) are supported
 static constexpr std::uint8_t kDMFFileVersionMax = 27; // DMF files as new as version 27 (0x1b) are supported
 
+static constexpr std::string_view kDMFHeader = ".DelekDefleMask.";
+static constexpr std::size_t kInflateChunkSize = 0x10000; // Pipelined import inflates the file this many bytes at a time
+static constexpr std::size_t kProbeBufferSize = 0x400; // Large enough for everything DMF::Probe reads
+static constexpr std::size_t kPipelineQueueCapacity = 4; // Max inflated chunks waiting to be parsed in pipelined import mode
+static constexpr std::size_t kParallelPatternsMinSize = 0x10000; // Smaller pattern data is decoded on one thread
+
 // DMF format magic numbers
 //static constexpr int kDMFNoInstrument = -1;
 static constexpr int kDMFNoVolume = -1;
 [[maybe_unused]] static constexpr int kDMFNoEffectVal = -1;
 
+/*
+ * A range of DMF format versions which all share the same file layout.
+ * Importer methods are instantiated once per range, so each range gets
+ * its own parser without any format version checks at run time.
+ */
+template<std::uint8_t min_version, std::uint8_t max_version>
+struct FormatVersions
+{
+	static_assert(min_version <= max_version);
+
+	static constexpr auto Contains(std::uint8_t version) -> bool { return version >= min_version && version <= max_version; }
+
+	/*
+	 * Whether every version in the range is the given version or newer.
+	 * Only use this in constant expressions: it fails to compile if the
+	 * range includes versions on both sides of the given version.
+	 */
+	static constexpr auto AtLeast(std::uint8_t version) -> bool
+	{
+		if (min_version >= version) { return true; }
+		if (max_version < version) { return false; }
+		throw std::logic_error{"DMF format version range is split by a format change"};
+	}
+};
+
+// All supported DMF format versions, split at every version where the file layout changes
+using SupportedFormatVersions = std::tuple<
+	FormatVersions<17, 17>,
+	FormatVersions<18, 18>,
+	FormatVersions<19, 19>,
+	FormatVersions<20, 21>,
+	FormatVersions<22, 23>,
+	FormatVersions<24, 24>,
+	FormatVersions<25, 25>,
+	FormatVersions<26, 26>,
+	FormatVersions<27, 27>
+>;
+
+static_assert(std::tuple_element_t<0, SupportedFormatVersions>::Contains(kDMFFileVersionMin)
+	&& std::tuple_element_t<std::tuple_size_v<SupportedFormatVersions> - 1, SupportedFormatVersions>::Contains(kDMFFileVersionMax));
+
+template<class Function, class... Ranges>
+static void VisitFormatVersion(std::uint8_t version, Function& func, std::tuple<Ranges...>)
+{
+	[[maybe_unused]] const bool found = ((Ranges::Contains(version) ? (func(Ranges{}), true) : false) || ...);
+	assert(found && "Unsupported DMF format version");
+}
+
+// Calls func with a FormatVersions object for the range containing the given version
+template<class Function>
+static void VisitFormatVersion(std::uint8_t version, Function&& func)
+{
+	VisitFormatVersion(version, func, SupportedFormatVersions{});
+}
+
+// Readers used by the importer for each import mode
+using DMFStreamReader = StreamReader<zstr::istream, Endianness::kLittle>;
+using DMFBufferReader = BufferReader<Endianness::kLittle>;
+using DMFPipelineReader = StreamReader<std::istream, Endianness::kLittle>;
+
+using Clock = std::chrono::steady_clock;
+
+// With kPacked storage, identical patterns share their rows once they're all loaded
+template<class Data>
+static void PoolPatterns(Data& data)
+{
+	if constexpr (Data::GetStorageType() == DataStorageType::kPacked) { data.PoolPatterns(); }
+}
+
+template<class Reader>
 class DMF::Importer
 {
 public:
-	using Reader = StreamReader<zstr::ifstream, Endianness::kLittle>;
-
 	Importer() = delete;
-	Importer(DMF& dmf, const std::string& filename) : dmf_(dmf), fin_(Reader{filename, std::ios_base::binary}), filename_(filename) {}
+	Importer(DMF& dmf, Reader& fin)
+		: dmf_(dmf), fin_(fin), skip_instruments_and_samples_(dmf.GetEffectiveImportProfile() == ImportProfile::kPatterns) {}
 	~Importer() = default;
 
 	void Import();
 
+	// Reads only the parts of the DMF file that come before the pattern matrix
+	static auto Probe(Reader& fin) -> dmf::Metadata;
+
 private:
-	void LoadVisualInfo();
-	void LoadModuleInfo(OrderIndex& num_orders, RowIndex& num_rows);
-	void LoadPatternMatrixValues(OrderIndex num_orders, RowIndex num_rows);
-	void LoadInstrumentsData();
-	auto LoadInstrument(SystemType system_type) -> dmf::Instrument;
-	void LoadWavetablesData();
+	// The header, visual info and module info are shared by Import and Probe, so they don't use the DMF object
+	static void LoadFormatHeader(Reader& fin, ModuleGlobalData<DMF>& global_data);
+	static void LoadVisualInfo(Reader& fin, ModuleGlobalData<DMF>& global_data);
+	template<class Versions> static void LoadModuleInfo(Reader& fin, ModuleGlobalData<DMF>& global_data, dmf::ModuleInfo& module_info, OrderIndex& num_orders, RowIndex& num_rows);
+
+	// Everything after the format header is parsed by methods specialized for a range of format versions
+	template<class Versions> void ImportSections(bool verbose);
+	template<class Versions> void LoadPatternMatrixValues(OrderIndex num_orders, RowIndex num_rows);
+	template<class Versions> void LoadInstrumentsData();
+	template<class Versions> auto LoadInstrument(SystemType system_type) -> dmf::Instrument;
+	template<class Versions> void SkipInstrument(SystemType system_type);
+	template<class Versions> void LoadWavetablesData();
 	void LoadPatternsData();
-	auto LoadPatternRow(uint8_t effect_columns_count) -> Row<DMF>;
-	void LoadPCMSamplesData();
-	auto LoadPCMSample() -> dmf::PCMSample;
+	static void LoadChannelPatterns(Reader& fin, ModuleData<DMF>& module_data, ChannelIndex channel, std::uint8_t effect_columns_count);
+	template<class Versions> void LoadPCMSamplesData();
+	template<class Versions> auto LoadPCMSample() -> dmf::PCMSample;
 
 	DMF& dmf_;
-	Reader fin_;
-	std::string filename_;
+	Reader& fin_;
+	const bool skip_instruments_and_samples_;
 };
 
 // Effect codes used by the DMF format
@@ -205,8 +302,228 @@ void DMF::CleanUp()
 
 void DMF::ImportImpl(const std::string& filename)
 {
-	auto importer = Importer{*this, filename};
-	importer.Import();
+	if (Utils::GetTypeFromFilename(filename) != ModuleType::kDMF)
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "Input file has the wrong file extension.\nPlease use a DMF file."};
+	}
+
+	const bool verbose = GlobalOptions::Get().GetOption(GlobalOptions::OptionEnum::kVerbose).GetValue<bool>();
+	if (verbose) { std::cout << "DMF Filename: " << filename << "\n"; }
+
+	// The file is mapped into memory, so it is inflated (or parsed in place if uncompressed) without extra copies
+	MappedFile file;
+	if (!file.Open(filename))
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "Failed to open DMF file."};
+	}
+
+	ImportImpl(file.Data(), file.Size());
+}
+
+void DMF::ImportImpl(const void* data, std::size_t size)
+{
+	if (!data && size > 0)
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "DMF buffer is null."};
+	}
+
+	import_timings_ = {};
+	try
+	{
+		if (import_mode_ == ImportMode::kStreaming)
+		{
+			auto source = MemoryStreamBuffer{data, size};
+			ImportStreaming(source);
+			return;
+		}
+
+		if (import_mode_ == ImportMode::kPipelined)
+		{
+			// Without threads (e.g. Emscripten without pthreads), pipelined import falls back to buffered import
+			auto source = MemoryStreamBuffer{data, size};
+			if (ImportPipelined(source)) { return; }
+		}
+
+		ImportBuffered(data, size);
+	}
+	catch (const zstr::Exception& e)
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, std::string{"Failed to decompress DMF file: "} + e.what()};
+	}
+	catch (const InflateError& e)
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, std::string{"Failed to decompress DMF file: "} + e.what()};
+	}
+}
+
+auto DMF::Probe(const std::string& filename) -> dmf::Metadata
+{
+	std::filebuf file;
+	if (!file.open(filename, std::ios_base::in | std::ios_base::binary))
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "Failed to open DMF file."};
+	}
+
+	return ProbeFromSource(file);
+}
+
+auto DMF::Probe(const void* data, std::size_t size) -> dmf::Metadata
+{
+	if (!data && size > 0)
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "DMF buffer is null."};
+	}
+
+	if (size >= kDMFHeader.size() && std::memcmp(data, kDMFHeader.data(), kDMFHeader.size()) == 0)
+	{
+		auto reader = DMFBufferReader{data, size};
+		auto metadata = Importer<DMFBufferReader>::Probe(reader);
+		if (reader.Overran())
+		{
+			throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "DMF file is truncated."};
+		}
+		return metadata;
+	}
+
+	auto source = MemoryStreamBuffer{data, size};
+	return ProbeFromSource(source);
+}
+
+auto DMF::ProbeFromSource(std::streambuf& source) -> dmf::Metadata
+{
+	try
+	{
+		// With a small buffer, zstr only inflates the start of the file
+		auto reader = DMFStreamReader{&source, kProbeBufferSize};
+		auto metadata = Importer<DMFStreamReader>::Probe(reader);
+		if (reader.stream().fail())
+		{
+			throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "DMF file is truncated."};
+		}
+		return metadata;
+	}
+	catch (const zstr::Exception& e)
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, std::string{"Failed to decompress DMF file: "} + e.what()};
+	}
+}
+
+auto DMF::GetEffectiveImportProfile() const -> ImportProfile
+{
+	if (import_profile_ != ImportProfile::kAuto) { return import_profile_; }
+
+	// The MOD converter only uses the patterns and wavetables
+	return GetConversionTarget() == ModuleType::kMOD ? ImportProfile::kPatterns : ImportProfile::kFull;
+}
+
+void DMF::ImportBuffered(const void* data, std::size_t size)
+{
+	// An uncompressed DMF file in memory can be parsed in place without copying it
+	std::vector<char> inflated;
+	if (size < kDMFHeader.size() || std::memcmp(data, kDMFHeader.data(), kDMFHeader.size()) != 0)
+	{
+		const auto inflate_start = Clock::now();
+		inflated = Inflate(data, size, inflate_backend_);
+		import_timings_.inflate = Clock::now() - inflate_start;
+		data = inflated.data();
+		size = inflated.size();
+	}
+
+	const auto parse_start = Clock::now();
+	auto reader = DMFBufferReader{data, size};
+	Importer<DMFBufferReader>{*this, reader}.Import();
+	import_timings_.parse = Clock::now() - parse_start;
+	if (reader.Overran())
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "DMF file is truncated."};
+	}
+}
+
+void DMF::ImportStreaming(std::streambuf& source)
+{
+	const auto parse_start = Clock::now();
+	auto reader = DMFStreamReader{&source};
+	Importer<DMFStreamReader>{*this, reader}.Import();
+	import_timings_.parse = Clock::now() - parse_start;
+	if (reader.stream().fail())
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "DMF file is truncated."};
+	}
+}
+
+auto DMF::ImportPipelined(std::streambuf& source) -> bool
+{
+	ChunkQueue queue{kPipelineQueueCapacity};
+	std::exception_ptr inflate_error;
+	Clock::duration inflate_time{};
+
+	// Producer: inflates the source into fixed-size chunks until it runs out of data or the parser stops early
+	auto inflate = [&]() {
+		const auto inflate_start = Clock::now();
+		try
+		{
+			// zstr passes uncompressed data through unchanged
+			zstr::istream stream{&source};
+			while (stream)
+			{
+				ChunkQueue::Chunk chunk(kInflateChunkSize);
+				stream.read(chunk.data(), kInflateChunkSize);
+				chunk.resize(static_cast<std::size_t>(stream.gcount()));
+				if (chunk.empty() || !queue.Push(std::move(chunk))) { break; }
+			}
+		}
+		catch (...)
+		{
+			inflate_error = std::current_exception();
+		}
+		inflate_time = Clock::now() - inflate_start;
+		queue.Close();
+	};
+
+	std::thread inflater;
+	try
+	{
+		inflater = std::thread{inflate};
+	}
+	catch (const std::system_error&)
+	{
+		return false;
+	}
+
+	// Consumer: parses the chunks on this thread as they arrive
+	const auto parse_start = Clock::now();
+	bool truncated = false;
+	try
+	{
+		ChunkQueueStreamBuffer chunks{queue};
+		auto reader = DMFPipelineReader{&chunks};
+		Importer<DMFPipelineReader>{*this, reader}.Import();
+		truncated = reader.stream().fail();
+
+		// Drain whatever is left so the inflater finishes (and reports any error) just like buffered import would
+		for (ChunkQueue::Chunk chunk; queue.Pop(chunk);) {}
+	}
+	catch (...)
+	{
+		queue.Cancel();
+		inflater.join();
+		if (inflate_error) { std::rethrow_exception(inflate_error); } // The parse error was likely caused by the inflate error
+		throw;
+	}
+	const auto parse_end = Clock::now();
+	inflater.join();
+
+	import_timings_.inflate_stall = queue.GetPushWaitTime();
+	import_timings_.parse_stall = queue.GetPopWaitTime();
+	import_timings_.inflate = inflate_time - import_timings_.inflate_stall;
+	import_timings_.parse = parse_end - parse_start - import_timings_.parse_stall;
+
+	if (inflate_error) { std::rethrow_exception(inflate_error); }
+	if (truncated)
+	{
+		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "DMF file is truncated."};
+	}
+	return true;
 }
 
 void DMF::ExportImpl(const std::string& filename)
@@ -215,6 +532,12 @@ void DMF::ExportImpl(const std::string& filename)
 	throw NotImplementedException{};
 }
 
+void DMF::ExportImpl(std::vector<std::byte>& buffer)
+{
+	// Not implemented
+	throw NotImplementedException{};
+}
+
 void DMF::ConvertImpl(const ModulePtr& input)
 {
 	// Not implemented
@@ -244,36 +567,116 @@ auto DMF::GetBPM() const -> double
 
 // Importer implementation
 
-void DMF::Importer::Import()
+template<class Reader>
+void DMF::Importer<Reader>::Import()
 {
 	dmf_.CleanUp();
 	const bool verbose = GlobalOptions::Get().GetOption(GlobalOptions::OptionEnum::kVerbose).GetValue<bool>();
 
 	if (verbose) { std::cout << "Starting to import the DMF file...\n"; }
 
-	if (Utils::GetTypeFromFilename(filename_) != ModuleType::kDMF)
+	auto& global_data = dmf_.GetGlobalData();
+
+	/// FORMAT FLAGS AND SYSTEM SET ///
+
+	LoadFormatHeader(fin_, global_data);
+	if (verbose)
 	{
-		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "Input file has the wrong file extension.\nPlease use a DMF file."};
+		std::stringstream stream;
+		stream << "0x" << std::setfill('0') << std::setw(2) << std::hex << static_cast<int>(global_data.dmf_format_version);
+		std::string hex = stream.str();
+
+		std::cout << "DMF version " << std::to_string(global_data.dmf_format_version) << " (" << hex << ")\n";
+		std::cout << "System: " << global_data.system.name << " (channels: " << std::to_string(global_data.system.channels) << ")\n";
 	}
 
-	if (verbose) { std::cout << "DMF Filename: " << filename_ << "\n"; }
+	// The format version is known now, so the rest can be parsed without checking it again
+	VisitFormatVersion(global_data.dmf_format_version, [&](auto versions) {
+		ImportSections<decltype(versions)>(verbose);
+	});
+
+	if (verbose) { std::cout << "Done importing DMF file.\n\n"; }
+}
+
+template<class Reader>
+template<class Versions>
+void DMF::Importer<Reader>::ImportSections(bool verbose)
+{
+	auto& global_data = dmf_.GetGlobalData();
+
+	/// VISUAL INFORMATION ///
 
-	if (fin_.stream().fail())
+	LoadVisualInfo(fin_, global_data);
+	if (verbose)
 	{
-		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "Failed to open DMF file."};
+		std::cout << "Title: " << dmf_.GetTitle() << "\n";
+		std::cout << "Author: " << dmf_.GetAuthor() << "\n";
+		std::cout << "Loaded visual information." << "\n";
 	}
 
-	/// FORMAT FLAGS ///
+	/// MODULE INFORMATION ///
+	OrderIndex num_orders;
+	RowIndex num_rows;
+	LoadModuleInfo<Versions>(fin_, global_data, dmf_.module_info_, num_orders, num_rows);
+	if (verbose) { std::cout << "Loaded module information.\n"; }
+
+	auto& offsets = dmf_.section_offsets_;
 
+	/// PATTERN MATRIX VALUES ///
+	offsets.pattern_matrix = fin_.GetPos();
+	LoadPatternMatrixValues<Versions>(num_orders, num_rows);
+	if (verbose) { std::cout << "Loaded pattern matrix values.\n"; }
+
+	/// INSTRUMENTS DATA ///
+	offsets.instruments = fin_.GetPos();
+	LoadInstrumentsData<Versions>();
+	if (verbose) { std::cout << (skip_instruments_and_samples_ ? "Skipped instruments.\n" : "Loaded instruments.\n"); }
+
+	/// WAVETABLES DATA ///
+	offsets.wavetables = fin_.GetPos();
+	LoadWavetablesData<Versions>();
+	if (verbose) { std::cout << "Loaded " << std::to_string(dmf_.total_wavetables_) << " wavetable(s).\n"; }
+
+	/// PATTERNS DATA ///
+	offsets.patterns = fin_.GetPos();
+	LoadPatternsData();
+	PoolPatterns(dmf_.GetData());
+	if (verbose) { std::cout << "Loaded patterns.\n"; }
+
+	/// PCM SAMPLES DATA ///
+	offsets.pcm_samples = fin_.GetPos();
+	LoadPCMSamplesData<Versions>();
+	if (verbose) { std::cout << (skip_instruments_and_samples_ ? "Skipped PCM sample data.\n" : "Loaded PCM samples.\n"); }
+}
+
+template<class Reader>
+auto DMF::Importer<Reader>::Probe(Reader& fin) -> dmf::Metadata
+{
+	ModuleGlobalData<DMF> global_data;
+	dmf::ModuleInfo module_info;
+	OrderIndex num_orders;
+	RowIndex num_rows;
+
+	LoadFormatHeader(fin, global_data);
+	VisitFormatVersion(global_data.dmf_format_version, [&](auto versions) {
+		LoadVisualInfo(fin, global_data);
+		LoadModuleInfo<decltype(versions)>(fin, global_data, module_info, num_orders, num_rows);
+	});
+
+	return dmf::Metadata{std::move(global_data.title), std::move(global_data.author), std::move(global_data.system),
+		global_data.dmf_format_version, num_orders, num_rows};
+}
+
+template<class Reader>
+void DMF::Importer<Reader>::LoadFormatHeader(Reader& fin, ModuleGlobalData<DMF>& global_data)
+{
 	// Check header
-	if (fin_.ReadStr(16) != ".DelekDefleMask.")
+	if (fin.ReadStr(kDMFHeader.size()) != kDMFHeader)
 	{
 		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "DMF format header is bad."};
 	}
 
-	auto& global_data = dmf_.GetGlobalData();
-
-	global_data.dmf_format_version = fin_.ReadInt();
+	global_data.dmf_format_version = fin.ReadInt();
 	if (global_data.dmf_format_version < kDMFFileVersionMin || global_data.dmf_format_version > kDMFFileVersionMax)
 	{
 		const bool too_high = global_data.dmf_format_version > kDMFFileVersionMax;
@@ -303,18 +706,8 @@ void DMF::Importer::Import()
 
 		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, error_msg};
 	}
-	else if (verbose)
-	{
-		std::stringstream stream;
-		stream << "0x" << std::setfill('0') << std::setw(2) << std::hex << static_cast<int>(global_data.dmf_format_version);
-		std::string hex = stream.str();
-
-		std::cout << "DMF version " << std::to_string(global_data.dmf_format_version) << " (" << hex << ")\n";
-	}
 
-	/// SYSTEM SET ///
-
-	const auto system_byte = fin_.ReadInt();
+	const auto system_byte = fin.ReadInt();
 	global_data.system = kDMFSystems.at(SystemType::kError);
 	for (const auto& map_pair : kDMFSystems)
 	{
@@ -328,73 +721,31 @@ void DMF::Importer::Import()
 	{
 		throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError, "Invalid system type"};
 	}
-
-	if (verbose)
-	{
-		std::cout << "System: " << global_data.system.name << " (channels: " << std::to_string(global_data.system.channels) << ")\n";
-	}
-
-	/// VISUAL INFORMATION ///
-
-	LoadVisualInfo();
-	if (verbose)
-	{
-		std::cout << "Title: " << dmf_.GetTitle() << "\n";
-		std::cout << "Author: " << dmf_.GetAuthor() << "\n";
-		std::cout << "Loaded visual information." << "\n";
-	}
-
-	/// MODULE INFORMATION ///
-	OrderIndex num_orders;
-	RowIndex num_rows;
-	LoadModuleInfo(num_orders, num_rows);
-	if (verbose) { std::cout << "Loaded module information.\n"; }
-
-	/// PATTERN MATRIX VALUES ///
-	LoadPatternMatrixValues(num_orders, num_rows);
-	if (verbose) { std::cout << "Loaded pattern matrix values.\n"; }
-
-	/// INSTRUMENTS DATA ///
-	LoadInstrumentsData();
-	if (verbose) { std::cout << "Loaded instruments.\n"; }
-
-	/// WAVETABLES DATA ///
-	LoadWavetablesData();
-	if (verbose) { std::cout << "Loaded " << std::to_string(dmf_.total_wavetables_) << " wavetable(s).\n"; }
-
-	/// PATTERNS DATA ///
-	LoadPatternsData();
-	if (verbose) { std::cout << "Loaded patterns.\n"; }
-
-	/// PCM SAMPLES DATA ///
-	LoadPCMSamplesData();
-	if (verbose) { std::cout << "Loaded PCM samples.\n"; }
-
-	if (verbose) { std::cout << "Done importing DMF file.\n\n"; }
 }
 
-void DMF::Importer::LoadVisualInfo()
+template<class Reader>
+void DMF::Importer<Reader>::LoadVisualInfo(Reader& fin, ModuleGlobalData<DMF>& global_data)
 {
-	dmf_.GetGlobalData().title = fin_.ReadPStr();
-	dmf_.GetGlobalData().author = fin_.ReadPStr();
-	dmf_.GetGlobalData().highlight_a_patterns = fin_.ReadInt();
-	dmf_.GetGlobalData().highlight_b_patterns = fin_.ReadInt();
+	global_data.title = fin.ReadPStr();
+	global_data.author = fin.ReadPStr();
+	global_data.highlight_a_patterns = fin.ReadInt();
+	global_data.highlight_b_patterns = fin.ReadInt();
 }
 
-void DMF::Importer::LoadModuleInfo(OrderIndex& num_orders, RowIndex& num_rows)
+template<class Reader>
+template<class Versions>
+void DMF::Importer<Reader>::LoadModuleInfo(Reader& fin, ModuleGlobalData<DMF>& global_data, dmf::ModuleInfo& module_info, OrderIndex& num_orders, RowIndex& num_rows)
 {
-	auto& module_info = dmf_.module_info_;
-	module_info.time_base = fin_.ReadInt() + 1;
-	module_info.tick_time1 = fin_.ReadInt();
-	module_info.tick_time2 = fin_.ReadInt();
+	module_info.time_base = fin.ReadInt() + 1;
+	module_info.tick_time1 = fin.ReadInt();
+	module_info.tick_time2 = fin.ReadInt();
 
-	auto& global_data = dmf_.GetGlobalData();
-	global_data.frames_mode = fin_.ReadInt();
+	global_data.frames_mode = fin.ReadInt();
 
-	const bool using_custom_hz = fin_.ReadInt();
+	const bool using_custom_hz = fin.ReadInt();
 
 	// Custom Hz integer is stored as 3 character ASCII string for god knows why
-	const auto custom_hz_str = fin_.ReadStr(3);
+	const auto custom_hz_str = fin.ReadStr(3);
 	if (using_custom_hz)
 	{
 		if (custom_hz_str[0] == '\0')
@@ -418,29 +769,31 @@ void DMF::Importer::LoadModuleInfo(OrderIndex& num_orders, RowIndex& num_rows)
 		global_data.custom_hz_value.reset();
 	}
 
-	if (global_data.dmf_format_version >= 24) // DMF version 24 (0x18) and newer.
+	if constexpr (Versions::AtLeast(24)) // DMF version 24 (0x18) and newer.
 	{
 		// Newer versions read 4 bytes here
-		num_rows = static_cast<RowIndex>(fin_.ReadInt<false, 4>());
+		num_rows = static_cast<RowIndex>(fin.template ReadInt<false, 4>());
 	}
 	else // DMF version 23 (0x17) and older. WARNING: I don't have the specs for version 23 (0x17), so this may be wrong.
 	{
 		// Earlier versions such as 22 (0x16) only read one byte here
-		num_rows = fin_.ReadInt();
+		num_rows = fin.ReadInt();
 	}
 
-	num_orders = fin_.ReadInt();
+	num_orders = fin.ReadInt();
 
 	// Prior to Deflemask Version 0.11.1, arpeggio tick speed was stored here
 	// I don't have the specs for DMF version 20 (0x14), but based on a real DMF file of that version,
 	//     it is the first DMF version to NOT contain the arpeggio tick speed byte.
-	if (global_data.dmf_format_version <= 19) // DMF version 19 (0x13) and older
+	if constexpr (!Versions::AtLeast(20)) // DMF version 19 (0x13) and older
 	{
-		fin_.ReadInt(); // arpTickSpeed: Discard for now
+		fin.ReadInt(); // arpTickSpeed: Discard for now
 	}
 }
 
-void DMF::Importer::LoadPatternMatrixValues(OrderIndex num_orders, RowIndex num_rows)
+template<class Reader>
+template<class Versions>
+void DMF::Importer<Reader>::LoadPatternMatrixValues(OrderIndex num_orders, RowIndex num_rows)
 {
 	auto& module_data = dmf_.GetData();
 	module_data.AllocatePatternMatrix(dmf_.GetSystem().channels, num_orders, num_rows);
@@ -455,7 +808,7 @@ void DMF::Importer::LoadPatternMatrixValues(OrderIndex num_orders, RowIndex num_
 			module_data.SetPatternId(channel, order, pattern_id);
 
 			// Version 1.1 introduces pattern names
-			if (dmf_.GetGlobalData().dmf_format_version >= 25) // DMF version 25 (0x19) and newer
+			if constexpr (Versions::AtLeast(25)) // DMF version 25 (0x19) and newer
 			{
 				std::string pattern_name = fin_.ReadPStr();
 				if (pattern_name.size() > 0)
@@ -477,18 +830,32 @@ void DMF::Importer::LoadPatternMatrixValues(OrderIndex num_orders, RowIndex num_
 	}
 }
 
-void DMF::Importer::LoadInstrumentsData()
+template<class Reader>
+template<class Versions>
+void DMF::Importer<Reader>::LoadInstrumentsData()
 {
-	dmf_.total_instruments_ = fin_.ReadInt();
+	const std::uint8_t total_instruments = fin_.ReadInt();
+	if (skip_instruments_and_samples_)
+	{
+		for (int i = 0; i < total_instruments; i++)
+		{
+			SkipInstrument<Versions>(dmf_.GetSystem().type);
+		}
+		return;
+	}
+
+	dmf_.total_instruments_ = total_instruments;
 	dmf_.instruments_ = new dmf::Instrument[dmf_.total_instruments_];
 
 	for (int i = 0; i < dmf_.total_instruments_; i++)
 	{
-		dmf_.instruments_[i] = LoadInstrument(dmf_.GetSystem().type);
+		dmf_.instruments_[i] = LoadInstrument<Versions>(dmf_.GetSystem().type);
 	}
 }
 
-auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrument
+template<class Reader>
+template<class Versions>
+auto DMF::Importer<Reader>::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrument
 {
 	dmf::Instrument inst{};
 
@@ -507,20 +874,18 @@ auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrume
 
 	// Now we can import the instrument depending on the mode (Standard/FM)
 
-	const auto dmf_format_version = dmf_.GetGlobalData().dmf_format_version;
+	// DMF version 17 and older always get the envelope loop position byte
+	constexpr bool always_has_loop_pos = !Versions::AtLeast(18);
+
 	if (inst.mode == dmf::Instrument::kStandardMode)
 	{
-		if (dmf_format_version <= 17) // DMF version 17 (0x11) or older
+		if constexpr (!Versions::AtLeast(18)) // DMF version 17 (0x11) or older
 		{
 			// Volume macro
 			inst.std.vol_env_size = fin_.ReadInt();
 			inst.std.vol_env_value = new std::int32_t[inst.std.vol_env_size];
 
-			for (int i = 0; i < inst.std.vol_env_size; i++)
-			{
-				// 4 bytes, little-endian
-				inst.std.vol_env_value[i] = fin_.ReadInt<true, 4>();
-			}
+			fin_.ReadInts(inst.std.vol_env_value, inst.std.vol_env_size);
 
 			// Always get envelope loop position byte regardless of envelope size
 			inst.std.vol_env_loop_pos = fin_.ReadInt();
@@ -531,11 +896,7 @@ auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrume
 			inst.std.vol_env_size = fin_.ReadInt();
 			inst.std.vol_env_value = new std::int32_t[inst.std.vol_env_size];
 
-			for (int i = 0; i < inst.std.vol_env_size; i++)
-			{
-				// 4 bytes, little-endian
-				inst.std.vol_env_value[i] = fin_.ReadInt<true, 4>();
-			}
+			fin_.ReadInts(inst.std.vol_env_value, inst.std.vol_env_size);
 
 			if (inst.std.vol_env_size > 0)
 			{
@@ -547,13 +908,9 @@ auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrume
 		inst.std.arp_env_size = fin_.ReadInt();
 		inst.std.arp_env_value = new std::int32_t[inst.std.arp_env_size];
 
-		for (int i = 0; i < inst.std.arp_env_size; i++)
-		{
-			// 4 bytes, little-endian
-			inst.std.arp_env_value[i] = fin_.ReadInt<true, 4>();
-		}
+		fin_.ReadInts(inst.std.arp_env_value, inst.std.arp_env_size);
 
-		if (inst.std.arp_env_size > 0 || dmf_format_version <= 17) // DMF version 17 and older always gets envelope loop position byte
+		if (inst.std.arp_env_size > 0 || always_has_loop_pos)
 		{
 			inst.std.arp_env_loop_pos = fin_.ReadInt();
 		}
@@ -564,13 +921,9 @@ auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrume
 		inst.std.duty_noise_env_size = fin_.ReadInt();
 		inst.std.duty_noise_env_value = new std::int32_t[inst.std.duty_noise_env_size];
 
-		for (int i = 0; i < inst.std.duty_noise_env_size; i++)
-		{
-			// 4 bytes, little-endian
-			inst.std.duty_noise_env_value[i] = fin_.ReadInt<true, 4>();
-		}
+		fin_.ReadInts(inst.std.duty_noise_env_value, inst.std.duty_noise_env_size);
 
-		if (inst.std.duty_noise_env_size > 0 || dmf_format_version <= 17) // DMF version 17 and older always gets envelope loop position byte
+		if (inst.std.duty_noise_env_size > 0 || always_has_loop_pos)
 		{
 			inst.std.duty_noise_env_loop_pos = fin_.ReadInt();
 		}
@@ -579,15 +932,10 @@ auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrume
 		inst.std.wavetable_env_size = fin_.ReadInt();
 		inst.std.wavetable_env_value = new std::int32_t[inst.std.wavetable_env_size];
 
-		for (int i = 0; i < inst.std.wavetable_env_size; i++)
-		{
-			// 4 bytes, little-endian
-			inst.std.wavetable_env_value[i] = fin_.ReadInt<true, 4>();
-		}
+		fin_.ReadInts(inst.std.wavetable_env_value, inst.std.wavetable_env_size);
 
-		if (inst.std.wavetable_env_size > 0 || dmf_format_version <= 17)
+		if (inst.std.wavetable_env_size > 0 || always_has_loop_pos)
 		{
-			// DMF version 17 and older always gets envelope loop position byte
 			inst.std.wavetable_env_loop_pos = fin_.ReadInt();
 		}
 
@@ -617,13 +965,16 @@ auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrume
 			inst.std.c64_filter_low_pass = fin_.ReadInt();
 			inst.std.c64_filter_ch2_off = fin_.ReadInt();
 		}
-		else if (system_type == DMF::SystemType::kGameBoy && dmf_format_version >= 18)
+		else if (system_type == DMF::SystemType::kGameBoy)
 		{
-			// Using Game Boy and DMF version is 18 or newer
-			inst.std.gb_env_vol = fin_.ReadInt();
-			inst.std.gb_env_dir = fin_.ReadInt();
-			inst.std.gb_env_len = fin_.ReadInt();
-			inst.std.gb_sound_len = fin_.ReadInt();
+			if constexpr (Versions::AtLeast(18))
+			{
+				// Using Game Boy and DMF version is 18 or newer
+				inst.std.gb_env_vol = fin_.ReadInt();
+				inst.std.gb_env_dir = fin_.ReadInt();
+				inst.std.gb_env_len = fin_.ReadInt();
+				inst.std.gb_sound_len = fin_.ReadInt();
+			}
 		}
 	}
 	else if (inst.mode == dmf::Instrument::kFMMode)
@@ -634,7 +985,7 @@ auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrume
 		inst.std.duty_noise_env_value = nullptr;
 		inst.std.wavetable_env_value = nullptr;
 
-		if (dmf_format_version > 18) // Newer than DMF version 18 (0x12)
+		if constexpr (Versions::AtLeast(19)) // Newer than DMF version 18 (0x12)
 		{
 			if (system_type == DMF::SystemType::kSMS_OPLL || system_type == DMF::SystemType::kNES_VRC7)
 			{
@@ -670,7 +1021,7 @@ auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrume
 
 		for (int i = 0; i < inst.fm.num_operators; i++)
 		{
-			if (dmf_format_version > 18) // Newer than DMF version 18 (0x12)
+			if constexpr (Versions::AtLeast(19)) // Newer than DMF version 18 (0x12)
 			{
 				inst.fm.ops[i].am = fin_.ReadInt();
 				inst.fm.ops[i].ar = fin_.ReadInt();
@@ -726,7 +1077,74 @@ auto DMF::Importer::LoadInstrument(DMF::SystemType system_type) -> dmf::Instrume
 	return inst;
 }
 
-void DMF::Importer::LoadWavetablesData()
+template<class Reader>
+template<class Versions>
+void DMF::Importer<Reader>::SkipInstrument(DMF::SystemType system_type)
+{
+	// Follows the same layout as LoadInstrument, but only reads what is needed to find the next instrument
+
+	fin_.Skip(fin_.ReadInt()); // Name
+
+	// DMF version 17 and older always get the envelope loop position byte
+	constexpr bool always_has_loop_pos = !Versions::AtLeast(18);
+
+	// Macros are a 1 byte size, 4 bytes per value, then the loop position byte
+	const auto skip_macro = [&](bool always_has_loop_pos) {
+		const std::uint8_t size = fin_.ReadInt();
+		fin_.Skip(size * 4 + (size > 0 || always_has_loop_pos ? 1 : 0));
+	};
+
+	switch (fin_.ReadInt())
+	{
+		case 0: // Standard mode
+			if constexpr (!Versions::AtLeast(18)) // DMF version 17 (0x11) or older
+			{
+				skip_macro(true); // Volume macro
+			}
+			else if (system_type != DMF::SystemType::kGameBoy)
+			{
+				skip_macro(false); // Volume macro
+			}
+
+			skip_macro(always_has_loop_pos); // Arpeggio macro
+			fin_.Skip(1); // Arpeggio macro mode
+			skip_macro(always_has_loop_pos); // Duty/Noise macro
+			skip_macro(always_has_loop_pos); // Wavetable macro
+
+			// Per system data
+			if (system_type == DMF::SystemType::kC64_SID_8580 || system_type == DMF::SystemType::kC64_SID_6581)
+			{
+				fin_.Skip(19);
+			}
+			else if (system_type == DMF::SystemType::kGameBoy)
+			{
+				if constexpr (Versions::AtLeast(18)) { fin_.Skip(4); }
+			}
+			break;
+
+		case 1: // FM mode
+			if constexpr (Versions::AtLeast(19)) // Newer than DMF version 18 (0x12)
+			{
+				// 4 bytes, then 12 bytes for each of the 4 operators
+				fin_.Skip(4 + 4 * 12);
+			}
+			else
+			{
+				fin_.Skip(6);
+				const bool totalOperatorsBool = fin_.ReadInt();
+				fin_.Skip(1 + (totalOperatorsBool ? 4 : 2) * 18);
+			}
+			break;
+
+		default:
+			throw ModuleException{Status::Category::kImport, ImportError::kUnspecifiedError,
+				"Invalid instrument mode"};
+	}
+}
+
+template<class Reader>
+template<class Versions>
+void DMF::Importer<Reader>::LoadWavetablesData()
 {
 	dmf_.total_wavetables_ = fin_.ReadInt();
 
@@ -743,71 +1161,93 @@ void DMF::Importer::LoadWavetablesData()
 		data_mask = 0x3F;
 	}
 
+	// Bug fix for DMF version 25 (0x19): Transform 4-bit FDS wavetables into 6-bit
+	const unsigned data_shift = !Versions::AtLeast(26) && dmf_.GetSystem().type == DMF::SystemType::kNES_FDS ? 2 : 0;
+
 	for (int i = 0; i < dmf_.total_wavetables_; i++)
 	{
-		dmf_.wavetable_sizes_[i] = fin_.ReadInt<false, 4>();
+		const std::uint32_t size = fin_.template ReadInt<false, 4>();
+		dmf_.wavetable_sizes_[i] = size;
 
-		dmf_.wavetable_values_[i] = new std::uint32_t[dmf_.wavetable_sizes_[i]];
+		auto* values = new std::uint32_t[size];
+		dmf_.wavetable_values_[i] = values;
+		fin_.ReadInts(values, size);
 
-		for (unsigned j = 0; j < dmf_.wavetable_sizes_[i]; j++)
+		// Done as a separate pass over the whole wavetable so it can be vectorized
+		for (std::uint32_t j = 0; j < size; j++)
 		{
-			dmf_.wavetable_values_[i][j] = fin_.ReadInt<false, 4>() & data_mask;
-
-			// Bug fix for DMF version 25 (0x19): Transform 4-bit FDS wavetables into 6-bit
-			if (dmf_.GetSystem().type == DMF::SystemType::kNES_FDS && dmf_.GetGlobalData().dmf_format_version <= 25)
-			{
-				dmf_.wavetable_values_[i][j] <<= 2; // x4
-			}
+			values[j] = (values[j] & data_mask) << data_shift;
 		}
 	}
 }
 
-void DMF::Importer::LoadPatternsData()
+// Maps DMF effect codes (0x00 - 0xFF) to dmf2mod's internal representation. Anything not listed is kNoEffect.
+static constexpr auto MakeEffectCodeTable() -> std::array<EffectCode, 256>
 {
-	auto& module_data = dmf_.GetData();
-	auto& channel_metadata = module_data.ChannelMetadataRef();
-
-	std::unordered_set<std::pair<ChannelIndex, PatternIndex>, PairHash> patterns_visited; // Storing channel/patternId pairs
-
-	for (ChannelIndex channel = 0; channel < module_data.GetNumChannels(); ++channel)
-	{
-		channel_metadata[channel].effect_columns_count = fin_.ReadInt();
+	std::array<EffectCode, 256> table{};
+	for (auto& effect_code : table) { effect_code = Effects::kNoEffect; }
+
+	table[dmf::EffectCode::kArp]                  = Effects::kArp;
+	table[dmf::EffectCode::kPortUp]               = Effects::kPortUp;
+	table[dmf::EffectCode::kPortDown]             = Effects::kPortDown;
+	table[dmf::EffectCode::kPort2Note]            = Effects::kPort2Note;
+	table[dmf::EffectCode::kVibrato]              = Effects::kVibrato;
+	table[dmf::EffectCode::kPort2NoteVolSlide]    = Effects::kPort2NoteVolSlide;
+	table[dmf::EffectCode::kVibratoVolSlide]      = Effects::kVibratoVolSlide;
+	table[dmf::EffectCode::kTremolo]              = Effects::kTremolo;
+	table[dmf::EffectCode::kPanning]              = Effects::kPanning;
+	table[dmf::EffectCode::kSetSpeedVal1]         = Effects::kSpeedA;
+	table[dmf::EffectCode::kVolSlide]             = Effects::kVolSlide;
+	table[dmf::EffectCode::kPosJump]              = Effects::kPosJump;
+	table[dmf::EffectCode::kRetrig]               = Effects::kRetrigger;
+	table[dmf::EffectCode::kPatBreak]             = Effects::kPatBreak;
+	table[dmf::EffectCode::kArpTickSpeed]         = dmf::Effects::kArpTickSpeed;
+	table[dmf::EffectCode::kNoteSlideUp]          = dmf::Effects::kNoteSlideUp;
+	table[dmf::EffectCode::kNoteSlideDown]        = dmf::Effects::kNoteSlideDown;
+	table[dmf::EffectCode::kSetVibratoMode]       = dmf::Effects::kSetVibratoMode;
+	table[dmf::EffectCode::kSetFineVibratoDepth]  = dmf::Effects::kSetFineVibratoDepth;
+	table[dmf::EffectCode::kSetFinetune]          = dmf::Effects::kSetFinetune;
+	table[dmf::EffectCode::kSetSamplesBank]       = dmf::Effects::kSetSamplesBank;
+	table[dmf::EffectCode::kNoteCut]              = Effects::kNoteCut;
+	table[dmf::EffectCode::kNoteDelay]            = Effects::kNoteDelay;
+	table[dmf::EffectCode::kSyncSignal]           = dmf::Effects::kSyncSignal;
+	table[dmf::EffectCode::kSetGlobalFinetune]    = dmf::Effects::kSetGlobalFinetune;
+	table[dmf::EffectCode::kSetSpeedVal2]         = Effects::kSpeedB;
+
+	// Game Boy exclusive:
+	table[dmf::EffectCode::kGameBoySetWave]                  = dmf::Effects::kGameBoySetWave;
+	table[dmf::EffectCode::kGameBoySetNoisePolyCounterMode]  = dmf::Effects::kGameBoySetNoisePolyCounterMode;
+	table[dmf::EffectCode::kGameBoySetDutyCycle]             = dmf::Effects::kGameBoySetDutyCycle;
+	table[dmf::EffectCode::kGameBoySetSweepTimeShift]        = dmf::Effects::kGameBoySetSweepTimeShift;
+	table[dmf::EffectCode::kGameBoySetSweepDir]              = dmf::Effects::kGameBoySetSweepDir;
+
+	return table;
+}
 
-		for (OrderIndex order = 0; order < module_data.GetNumOrders(); ++order)
-		{
-			const PatternIndex pattern_id = module_data.GetPatternId(channel, order);
+static constexpr auto kEffectCodeTable = MakeEffectCodeTable();
 
-			if (patterns_visited.count({channel, pattern_id}) > 0) // If pattern has been loaded previously
-			{
-				// Skip patterns that have already been loaded (unnecessary information)
-				// zstr's seekg method does not seem to work, so I will use this:
-				unsigned seek_amount = (8 + 4 * channel_metadata[channel].effect_columns_count) * module_data.GetNumRows();
-				while (0 < seek_amount--)
-				{
-					fin_.ReadInt();
-				}
-				continue;
-			}
-			else
-			{
-				// Mark this pattern_id for this channel as visited
-				patterns_visited.insert({channel, pattern_id});
-			}
-
-			for (RowIndex row = 0; row < module_data.GetNumRows(); ++row)
-			{
-				module_data.SetRowById(channel, pattern_id, row, LoadPatternRow(channel_metadata[channel].effect_columns_count));
-			}
-		}
-	}
+// kNoEffect (-1) and unknown codes fall outside the table and map to Effects::kNoEffect
+// TODO: Set a warning for unknown effect codes?
+static constexpr auto ConvertEffectCode(std::int16_t dmf_effect_code) -> EffectCode
+{
+	const auto index = static_cast<std::uint16_t>(dmf_effect_code);
+	return index < kEffectCodeTable.size() ? kEffectCodeTable[index] : EffectCode{Effects::kNoEffect};
 }
 
-auto DMF::Importer::LoadPatternRow(uint8_t effect_columns_count) -> Row<DMF>
+static_assert(ConvertEffectCode(dmf::EffectCode::kNoEffect) == Effects::kNoEffect);
+static_assert(ConvertEffectCode(dmf::EffectCode::kArp) == Effects::kArp);
+static_assert(ConvertEffectCode(dmf::EffectCode::kGameBoySetSweepDir) == dmf::Effects::kGameBoySetSweepDir);
+
+/*
+ * Decodes one pattern row from its fixed-size record of 16-bit words:
+ * pitch, octave, volume, effect_columns_count * (code, value), instrument
+ */
+static inline auto DecodePatternRow(const std::int16_t* words, std::uint8_t effect_columns_count) -> Row<DMF>
 {
 	Row<DMF> row;
 
-	const std::uint16_t temp_pitch = fin_.ReadInt<false, 2>();
-	auto temp_octave = static_cast<std::uint8_t>(fin_.ReadInt<false, 2>()); // Upper byte is unused
+	const auto temp_pitch = static_cast<std::uint16_t>(words[0]);
+	auto temp_octave = static_cast<std::uint8_t>(words[1]); // Upper byte is unused
 
 	switch (temp_pitch)
 	{
@@ -833,92 +1273,249 @@ auto DMF::Importer::LoadPatternRow(uint8_t effect_columns_count) -> Row<DMF>
 			break;
 	}
 
-	row.volume = fin_.ReadInt<true, 2>();
+	row.volume = words[2];
+
+	// DMF valueless effect magic number is -1, and so must be kEffectValueless
+	static_assert(kEffectValueless == kDMFNoEffectVal);
+
+	// A malformed file can claim more than 4 effects columns (the max in Deflemask). Only the first 4 are kept,
+	//  but the record still contains all of them.
+	const std::int16_t* effect_words = words + 3;
+	const std::uint8_t stored_columns = std::min<std::uint8_t>(effect_columns_count, 4);
+	for (std::uint8_t col = 0; col < stored_columns; ++col)
+	{
+		row.effect[col] = {ConvertEffectCode(effect_words[2 * col]), effect_words[2 * col + 1]};
+	}
+
+	// Initialize the rest to zero
+	for (std::uint8_t col = stored_columns; col < 4; ++col)
+	{
+		row.effect[col] = {Effects::kNoEffect, 0};
+	}
+
+	row.instrument = effect_words[2 * effect_columns_count];
+
+	return row;
+}
+
+static constexpr std::size_t kPackedRowHeaderSize = 5; // note, volume, instrument
+static constexpr std::size_t kPackedEffectSize = 3; // code, value
+
+template<class T>
+static inline void PutPacked(std::byte*& out, T value)
+{
+	std::memcpy(out, &value, sizeof(T));
+	out += sizeof(T);
+}
+
+template<class T>
+static inline auto GetPacked(const std::byte*& in) -> T
+{
+	T value;
+	std::memcpy(&value, in, sizeof(T));
+	in += sizeof(T);
+	return value;
+}
+
+static inline auto PackedEffectColumns(const ChannelMetadata<DMF>& metadata) -> std::size_t
+{
+	return std::min<std::size_t>(metadata.effect_columns_count, 4); // Max total of 4 effects columns in Deflemask
+}
+
+auto RowPacking<DMF>::GetEffectColumns(const ChannelMetadata<DMF>& metadata) -> std::size_t
+{
+	return PackedEffectColumns(metadata);
+}
+
+auto RowPacking<DMF>::GetEffect(const std::byte* in, std::size_t col) -> Effect
+{
+	in += kPackedRowHeaderSize + col * kPackedEffectSize;
+	const auto code = GetPacked<EffectCode>(in);
+	return {code, GetPacked<EffectValue>(in)};
+}
+
+auto RowPacking<DMF>::GetPackedSize(const ChannelMetadata<DMF>& metadata) -> std::size_t
+{
+	return kPackedRowHeaderSize + PackedEffectColumns(metadata) * kPackedEffectSize;
+}
+
+void RowPacking<DMF>::Pack(const Row<DMF>& row, const ChannelMetadata<DMF>& metadata, std::byte* out)
+{
+	PutPacked(out, row.note);
+	PutPacked(out, row.volume);
+	PutPacked(out, row.instrument);
+	for (std::size_t col = 0; col < PackedEffectColumns(metadata); ++col)
+	{
+		PutPacked(out, row.effect[col].code);
+		PutPacked(out, row.effect[col].value);
+	}
+}
+
+auto RowPacking<DMF>::Unpack(const std::byte* in, const ChannelMetadata<DMF>& metadata) -> Row<DMF>
+{
+	Row<DMF> row;
+
+	row.note = GetPacked<NoteSlot>(in);
+	row.volume = GetPacked<std::int16_t>(in);
+	row.instrument = GetPacked<std::int16_t>(in);
+
+	const std::size_t effect_columns = PackedEffectColumns(metadata);
+	for (std::size_t col = 0; col < effect_columns; ++col)
+	{
+		const auto code = GetPacked<EffectCode>(in);
+		row.effect[col] = {code, GetPacked<EffectValue>(in)};
+	}
+
+	// Unused effects columns are the same as the ones DecodePatternRow fills in
+	for (std::size_t col = effect_columns; col < 4; ++col)
+	{
+		row.effect[col] = {Effects::kNoEffect, 0};
+	}
+
+	return row;
+}
 
-	for (std::uint8_t col = 0; col < effect_columns_count; ++col)
+/*
+ * Calls func(i) for every i in [0, count) using a pool of worker threads plus the calling thread.
+ * func must not throw. Falls back to running everything on the calling thread if threads are unavailable.
+ */
+template<class Function>
+static void ParallelFor(std::size_t count, Function&& func)
+{
+	std::atomic<std::size_t> next{0};
+	auto worker = [&]() {
+		for (std::size_t i = next++; i < count; i = next++) { func(i); }
+	};
+
+	std::vector<std::thread> threads;
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	const std::size_t num_threads = std::min<std::size_t>(count, std::max(std::thread::hardware_concurrency(), 1u));
+	try
 	{
-		const std::int16_t dmf_effect_code = fin_.ReadInt<true, 2>();
-		row.effect[col].value = fin_.ReadInt<true, 2>();
+		for (std::size_t i = 1; i < num_threads; ++i) { threads.emplace_back(worker); }
+	}
+	catch (const std::system_error&)
+	{
+		// Couldn't start another thread - the threads already running will pick up the remaining work
+	}
+#endif
 
-		// DMF valueless effect magic number is -1, and so must be kEffectValueless
-		assert(kEffectValueless == kDMFNoEffectVal);
+	worker();
+	for (auto& thread : threads) { thread.join(); }
+}
+
+template<class Reader>
+void DMF::Importer<Reader>::LoadPatternsData()
+{
+	auto& module_data = dmf_.GetData();
+	const ChannelIndex num_channels = module_data.GetNumChannels();
 
-		// Convert DMF effect code to dmf2mod's internal representation
-		EffectCode effect_code = Effects::kNoEffect;
-		switch (dmf_effect_code)
+	if constexpr (std::is_same_v<Reader, DMFBufferReader>)
+	{
+		// Every channel's patterns are stored as one fixed-size block which follows the channel's
+		// effect columns count, so the offset of each block can be found without decoding anything
+		const std::size_t pattern_size = static_cast<std::size_t>(module_data.GetNumOrders()) * module_data.GetNumRows();
+		std::vector<const char*> channel_blocks(num_channels);
+		std::vector<std::uint8_t> channel_effect_columns(num_channels);
+		std::size_t offset = 0;
+		ChannelIndex scanned_channels = 0;
+		for (; scanned_channels < num_channels && offset < fin_.Remaining(); ++scanned_channels)
 		{
-			case dmf::EffectCode::kNoEffect:             effect_code = Effects::kNoEffect; break;
-			case dmf::EffectCode::kArp:                  effect_code = Effects::kArp; break;
-			case dmf::EffectCode::kPortUp:               effect_code = Effects::kPortUp; break;
-			case dmf::EffectCode::kPortDown:             effect_code = Effects::kPortDown; break;
-			case dmf::EffectCode::kPort2Note:            effect_code = Effects::kPort2Note; break;
-			case dmf::EffectCode::kVibrato:              effect_code = Effects::kVibrato; break;
-			case dmf::EffectCode::kPort2NoteVolSlide:    effect_code = Effects::kPort2NoteVolSlide; break;
-			case dmf::EffectCode::kVibratoVolSlide:      effect_code = Effects::kVibratoVolSlide; break;
-			case dmf::EffectCode::kTremolo:              effect_code = Effects::kTremolo; break;
-			case dmf::EffectCode::kPanning:              effect_code = Effects::kPanning; break;
-			case dmf::EffectCode::kSetSpeedVal1:         effect_code = Effects::kSpeedA; break;
-			case dmf::EffectCode::kVolSlide:             effect_code = Effects::kVolSlide; break;
-			case dmf::EffectCode::kPosJump:              effect_code = Effects::kPosJump; break;
-			case dmf::EffectCode::kRetrig:               effect_code = Effects::kRetrigger; break;
-			case dmf::EffectCode::kPatBreak:             effect_code = Effects::kPatBreak; break;
-			case dmf::EffectCode::kArpTickSpeed:         effect_code = dmf::Effects::kArpTickSpeed; break;
-			case dmf::EffectCode::kNoteSlideUp:          effect_code = dmf::Effects::kNoteSlideUp; break;
-			case dmf::EffectCode::kNoteSlideDown:        effect_code = dmf::Effects::kNoteSlideDown; break;
-			case dmf::EffectCode::kSetVibratoMode:       effect_code = dmf::Effects::kSetVibratoMode; break;
-			case dmf::EffectCode::kSetFineVibratoDepth:  effect_code = dmf::Effects::kSetFineVibratoDepth; break;
-			case dmf::EffectCode::kSetFinetune:          effect_code = dmf::Effects::kSetFinetune; break;
-			case dmf::EffectCode::kSetSamplesBank:       effect_code = dmf::Effects::kSetSamplesBank; break;
-			case dmf::EffectCode::kNoteCut:              effect_code = Effects::kNoteCut; break;
-			case dmf::EffectCode::kNoteDelay:            effect_code = Effects::kNoteDelay; break;
-			case dmf::EffectCode::kSyncSignal:           effect_code = dmf::Effects::kSyncSignal; break;
-			case dmf::EffectCode::kSetGlobalFinetune:    effect_code = dmf::Effects::kSetGlobalFinetune; break;
-			case dmf::EffectCode::kSetSpeedVal2:         effect_code = Effects::kSpeedB; break;
-
-			// Game Boy exclusive:
-			case dmf::EffectCode::kGameBoySetWave:                   effect_code = dmf::Effects::kGameBoySetWave; break;
-			case dmf::EffectCode::kGameBoySetNoisePolyCounterMode:   effect_code = dmf::Effects::kGameBoySetNoisePolyCounterMode; break;
-			case dmf::EffectCode::kGameBoySetDutyCycle:              effect_code = dmf::Effects::kGameBoySetDutyCycle; break;
-			case dmf::EffectCode::kGameBoySetSweepTimeShift:         effect_code = dmf::Effects::kGameBoySetSweepTimeShift; break;
-			case dmf::EffectCode::kGameBoySetSweepDir:               effect_code = dmf::Effects::kGameBoySetSweepDir; break;
+			const ChannelIndex channel = scanned_channels;
+			const std::uint8_t effect_columns_count = fin_.Data()[offset];
+			channel_effect_columns[channel] = effect_columns_count;
+			channel_blocks[channel] = fin_.Data() + offset + 1;
+			offset += 1 + pattern_size * (8 + 4 * effect_columns_count);
+		}
 
-			default:
-				// Set a warning here? (unable to parse effect code)
-				break;
+		// Truncated files and files too small to benefit from threads are loaded serially. A file which
+		//  ends at the end of a channel's block is truncated too, even though every scanned block is complete.
+		if (num_channels > 1 && scanned_channels == num_channels && offset >= kParallelPatternsMinSize && offset <= fin_.Remaining())
+		{
+			// Setting the metadata allocates each channel's patterns, which must happen before any thread writes to them
+			for (ChannelIndex channel = 0; channel < num_channels; ++channel)
+			{
+				module_data.SetChannelMetadata(channel, {channel_effect_columns[channel]});
+			}
+
+			ParallelFor(num_channels, [&](std::size_t channel) {
+				const std::uint8_t effect_columns_count = channel_effect_columns[channel];
+				DMFBufferReader channel_fin{channel_blocks[channel], pattern_size * (8 + 4 * effect_columns_count)};
+				LoadChannelPatterns(channel_fin, module_data, static_cast<ChannelIndex>(channel), effect_columns_count);
+			});
+
+			fin_.Skip(offset);
+			return;
 		}
-		row.effect[col].code = effect_code;
 	}
 
-	// Initialize the rest to zero
-	for (std::uint8_t col = effect_columns_count; col < 4; ++col) // Max total of 4 effects columns in Deflemask
+	for (ChannelIndex channel = 0; channel < num_channels; ++channel)
 	{
-		row.effect[col] = {Effects::kNoEffect, 0};
+		const std::uint8_t effect_columns_count = fin_.ReadInt();
+		module_data.SetChannelMetadata(channel, {effect_columns_count});
+		LoadChannelPatterns(fin_, module_data, channel, effect_columns_count);
 	}
+}
 
-	row.instrument = fin_.ReadInt<true, 2>();
+template<class Reader>
+void DMF::Importer<Reader>::LoadChannelPatterns(Reader& fin, ModuleData<DMF>& module_data, ChannelIndex channel, std::uint8_t effect_columns_count)
+{
+	const RowIndex num_rows = module_data.GetNumRows();
 
-	return row;
+	std::vector<bool> patterns_visited(module_data.GetNumPatterns(channel), false);
+
+	// Each pattern is read as one block of 16-bit words, then decoded row by row
+	const std::size_t row_words = 4 + 2 * effect_columns_count;
+	std::vector<std::int16_t> pattern_words(row_words * num_rows);
+
+	for (OrderIndex order = 0; order < module_data.GetNumOrders(); ++order)
+	{
+		const PatternIndex pattern_id = module_data.GetPatternId(channel, order);
+
+		if (patterns_visited[pattern_id]) // If pattern has been loaded previously
+		{
+			// Skip patterns that have already been loaded (unnecessary information)
+			fin.Skip(pattern_words.size() * sizeof(std::int16_t));
+			continue;
+		}
+		else
+		{
+			// Mark this pattern_id for this channel as visited
+			patterns_visited[pattern_id] = true;
+		}
+
+		fin.ReadInts(pattern_words.data(), pattern_words.size());
+
+		const std::int16_t* words = pattern_words.data();
+		for (RowIndex row = 0; row < num_rows; ++row, words += row_words)
+		{
+			module_data.SetRowById(channel, pattern_id, row, DecodePatternRow(words, effect_columns_count));
+		}
+	}
 }
 
-void DMF::Importer::LoadPCMSamplesData()
+template<class Reader>
+template<class Versions>
+void DMF::Importer<Reader>::LoadPCMSamplesData()
 {
 	dmf_.total_pcm_samples_ = fin_.ReadInt();
 	dmf_.pcm_samples_ = new dmf::PCMSample[dmf_.total_pcm_samples_];
 
 	for (unsigned sample = 0; sample < dmf_.total_pcm_samples_; sample++)
 	{
-		dmf_.pcm_samples_[sample] = LoadPCMSample();
+		dmf_.pcm_samples_[sample] = LoadPCMSample<Versions>();
 	}
 }
 
-auto DMF::Importer::LoadPCMSample() -> dmf::PCMSample
+template<class Reader>
+template<class Versions>
+auto DMF::Importer<Reader>::LoadPCMSample() -> dmf::PCMSample
 {
 	dmf::PCMSample sample;
 
-	sample.size = fin_.ReadInt<false, 4>();
+	sample.size = fin_.template ReadInt<false, 4>();
 
-	const auto dmf_format_version = dmf_.GetGlobalData().dmf_format_version;
-	if (dmf_format_version >= 24) // DMF version 24 (0x18)
+	if constexpr (Versions::AtLeast(24)) // DMF version 24 (0x18)
 	{
 		// Read PCM sample name
 		sample.name = fin_.ReadPStr();
@@ -934,15 +1531,15 @@ auto DMF::Importer::LoadPCMSample() -> dmf::PCMSample
 	sample.pitch = fin_.ReadInt();
 	sample.amp = fin_.ReadInt();
 
-	if (dmf_format_version >= 22) // DMF version 22 (0x16) and newer
+	if constexpr (Versions::AtLeast(22)) // DMF version 22 (0x16) and newer
 	{
 		sample.bits = fin_.ReadInt();
 	}
 
-	if (dmf_format_version >= 27) // DMF version 27 (0x1b) and newer
+	if constexpr (Versions::AtLeast(27)) // DMF version 27 (0x1b) and newer
 	{
-		sample.cut_start = fin_.ReadInt<false, 4>();
-		sample.cut_end = fin_.ReadInt<false, 4>();
+		sample.cut_start = fin_.template ReadInt<false, 4>();
+		sample.cut_end = fin_.template ReadInt<false, 4>();
 		if (sample.cut_start < 0 || sample.cut_start > sample.size)
 		{
 			throw ModuleException{ModuleException::Category::kImport, DMF::ImportError::kUnspecifiedError,
@@ -968,16 +1565,58 @@ auto DMF::Importer::LoadPCMSample() -> dmf::PCMSample
 	sample.data = nullptr;
 	if (sample.size > 0)
 	{
-		sample.data = new std::uint16_t[sample.size];
-		for (std::uint32_t i = 0; i < sample.size; i++)
+		if (skip_instruments_and_samples_)
 		{
-			sample.data[i] = fin_.ReadInt<false, 2>();
+			fin_.Skip(sample.size * 2);
+		}
+		else
+		{
+			sample.data = new std::uint16_t[sample.size];
+			fin_.ReadInts(sample.data, sample.size);
 		}
 	}
 
 	return sample;
 }
 
+/*
+ * Calls func with each effect in a channel's row, reading only the effects. With kPacked storage
+ * they are read straight from the packed row, and with kColumnar storage only the effects columns
+ * are touched. Effects columns which aren't stored would only hold kNoEffect, so they are skipped.
+ */
+template<class Data, class Func>
+static void ForEachRowEffect(const Data& data, ChannelIndex channel, OrderIndex order, RowIndex row, Func&& func)
+{
+	if constexpr (Data::GetStorageType() == DataStorageType::kPacked)
+	{
+		const std::byte* packed_row = data.GetPackedRow(channel, data.GetPatternId(channel, order), row);
+		const std::size_t effect_columns = RowPacking<DMF>::GetEffectColumns(data.GetChannelMetadata(channel));
+		for (std::size_t col = 0; col < effect_columns; ++col)
+		{
+			func(RowPacking<DMF>::GetEffect(packed_row, col));
+		}
+	}
+	else if constexpr (Data::GetStorageType() == DataStorageType::kColumnar)
+	{
+		using Columns = RowColumns<DMF>;
+		const auto effects = std::array {
+			data.template GetColumn<Columns::kEffect0>(channel, order),
+			data.template GetColumn<Columns::kEffect1>(channel, order),
+			data.template GetColumn<Columns::kEffect2>(channel, order),
+			data.template GetColumn<Columns::kEffect3>(channel, order)
+		};
+		const std::size_t effect_columns = std::min<std::size_t>(data.GetChannelMetadata(channel).effect_columns_count, effects.size());
+		for (std::size_t col = 0; col < effect_columns; ++col)
+		{
+			func(effects[col][row]);
+		}
+	}
+	else
+	{
+		for (const Effect& effect : data.GetRow(channel, order, row).effect) { func(effect); }
+	}
+}
+
 /*
  * Currently only supports the Game Boy system.
  *
@@ -1489,11 +2128,10 @@ auto DMF::GenerateDataImpl(std::size_t data_flags) const -> std::size_t
 					std::optional<EffectValueXX> pos_jump, pat_break, speed_a, speed_b, tempo;
 					bool ignore_pos_jump = false, ignore_pat_break = false;
 
-					// Want to check all channels to update the global state for this row
+					// Want to check all channels to update the global state for this row.
 					for (ChannelIndex channel2 = 0; channel2 < data.GetNumChannels(); ++channel2)
 					{
-						const auto& row_data2 = data.GetRow(channel2, order, row);
-						for (const auto& effect : row_data2.effect)
+						ForEachRowEffect(data, channel2, order, row, [&](const Effect& effect)
 						{
 							//const std::uint8_t effect_value_normal = effect.value != kEffectValueless ? effect.value : 0; // ???
 							switch (effect.code)
@@ -1534,7 +2172,7 @@ auto DMF::GenerateDataImpl(std::size_t data_flags) const -> std::size_t
 								default:
 									break;
 							}
-						}
+						});
 					}
 
 					// If we're on an order that starts on a row > 0 (due to a PatBreak),
@@ -1683,8 +2321,7 @@ auto DMF::GenerateDataImpl(std::size_t data_flags) const -> std::size_t
 			for (ChannelIndex channel = 0; channel < data.GetNumChannels(); ++channel)
 			{
 				auto& channel_state = channel_states[channel];
-				channel_state.Reset();
-				channel_state.SetReadPos(to);
+				channel_state.Seek(to);
 				channel_state.SetWritePos(to);
 
 				const auto state_before_loop = channel_state.ReadAt(from);
@@ -1717,6 +2354,8 @@ auto DMF::GenerateDataImpl(std::size_t data_flags) const -> std::size_t
 		}
 	}
 
+	state_data.CreateCheckpoints(gen_data.Get<GenDataEnumCommon::kTotalOrders>().value());
+
 	return return_val;
 }
 
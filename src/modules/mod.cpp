@@ -17,12 +17,15 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <numeric>
 #include <set>
+#include <string_view>
 
 namespace d2m {
 
@@ -94,9 +97,10 @@ using MODOptionEnum = MODConversionOptions::OptionEnum;
 
 static auto GenerateSquareWaveSample(unsigned duty_cycle, unsigned length) -> std::vector<std::int8_t>;
 static auto GenerateWavetableSample(uint32_t* wavetable_data, unsigned length) -> std::vector<std::int8_t>;
-static auto GetEffectCode(int effect_code) -> std::uint8_t;
 static auto GetWarningMessage(MOD::ConvertWarning warning, const std::string& info = "") -> std::string;
 
+static constexpr int kMaxSamples = 31; // Not counting sample #0
+
 /*
  * Game Boy's range is:  C-0 -> C-8 (though notes lower than C-2 just play as C-2)
  * ProTracker's range is:  C-1 -> B-3  (plus octaves 0 and 4 which are non-standard) 
@@ -157,12 +161,74 @@ namespace mod::EffectCode {
 	};
 } // namespace mod::EffectCode
 
+/*
+ * Maps dmf2mod internal effect codes to MOD effect codes. Indexed by the internal code cast to std::uint8_t.
+ * Codes without a MOD equivalent are -1.
+ */
+static constexpr auto MakeEffectCodeTable() -> std::array<std::int16_t, 256>
+{
+	std::array<std::int16_t, 256> table{};
+	for (auto& effect_code : table) { effect_code = -1; }
+
+	auto set = [&table](int effect, std::int16_t mod_effect_code) { table[static_cast<std::uint8_t>(effect)] = mod_effect_code; };
+
+	// Common effects:
+	set(d2m::Effects::kNoEffect,            mod::EffectCode::kNoEffect);
+	set(d2m::Effects::kArp,                 mod::EffectCode::kArp);
+	set(d2m::Effects::kPortUp,              mod::EffectCode::kPortUp);
+	set(d2m::Effects::kPortDown,            mod::EffectCode::kPortDown);
+	set(d2m::Effects::kPort2Note,           mod::EffectCode::kPort2Note);
+	set(d2m::Effects::kVibrato,             mod::EffectCode::kVibrato);
+	set(d2m::Effects::kPort2NoteVolSlide,   mod::EffectCode::kPort2NoteVolSlide);
+	set(d2m::Effects::kVibratoVolSlide,     mod::EffectCode::kVibratoVolSlide);
+	set(d2m::Effects::kTremolo,             mod::EffectCode::kTremolo);
+	set(d2m::Effects::kPanning,             mod::EffectCode::kPanning);
+	set(d2m::Effects::kSpeedA,              mod::EffectCode::kSetSpeed);
+	set(d2m::Effects::kVolSlide,            mod::EffectCode::kVolSlide);
+	set(d2m::Effects::kPosJump,             mod::EffectCode::kPosJump);
+	set(d2m::Effects::kRetrigger,           mod::EffectCode::kRetriggerSample);
+	set(d2m::Effects::kPatBreak,            mod::EffectCode::kPatBreak);
+	set(d2m::Effects::kNoteCut,             mod::EffectCode::kCutSample);
+	set(d2m::Effects::kNoteDelay,           mod::EffectCode::kDelaySample);
+	set(d2m::Effects::kTempo,               mod::EffectCode::kSetSpeed); // Same as kSpeedA, but different effect values are used
+	// d2m::Effects::kSpeedB is unsupported
+
+	// ProTracker-specific effects:
+	set(mod::Effects::kSetSampleOffset,     mod::EffectCode::kSetSampleOffset);
+	set(mod::Effects::kSetVolume,           mod::EffectCode::kSetVolume);
+	set(mod::Effects::kSetFilter,           mod::EffectCode::kSetFilter);
+	set(mod::Effects::kFineSlideUp,         mod::EffectCode::kFineSlideUp);
+	set(mod::Effects::kFineSlideDown,       mod::EffectCode::kFineSlideDown);
+	set(mod::Effects::kSetGlissando,        mod::EffectCode::kSetGlissando);
+	set(mod::Effects::kSetVibratoWaveform,  mod::EffectCode::kSetVibratoWaveform);
+	set(mod::Effects::kSetFinetune,         mod::EffectCode::kSetFinetune);
+	set(mod::Effects::kLoopPattern,         mod::EffectCode::kLoopPattern);
+	set(mod::Effects::kSetTremoloWaveform,  mod::EffectCode::kSetTremoloWaveform);
+	set(mod::Effects::kFineVolSlideUp,      mod::EffectCode::kFineVolSlideUp);
+	set(mod::Effects::kFineVolSlideDown,    mod::EffectCode::kFineVolSlideDown);
+	set(mod::Effects::kDelayPattern,        mod::EffectCode::kDelayPattern);
+	set(mod::Effects::kInvertLoop,          mod::EffectCode::kInvertLoop);
+
+	return table;
+}
+
+static constexpr auto kEffectCodeTable = MakeEffectCodeTable();
+
+static_assert(kEffectCodeTable[static_cast<std::uint8_t>(d2m::Effects::kPatBreak)] == mod::EffectCode::kPatBreak);
+static_assert(kEffectCodeTable[static_cast<std::uint8_t>(d2m::Effects::kSpeedB)] == -1);
+
 void MOD::ImportImpl(const std::string& filename)
 {
 	// Not implemented
 	throw NotImplementedException{};
 }
 
+void MOD::ImportImpl(const void* data, std::size_t size)
+{
+	// Not implemented
+	throw NotImplementedException{};
+}
+
 void MOD::ConvertImpl(const ModulePtr& input)
 {
 	if (!input)
@@ -605,9 +671,13 @@ void MOD::DMFConverter::ConvertSamples(SampleMap& sample_map)
 		}
 	}
 
-	mod_.total_mod_samples_ = mod_current_sound_index - 1; // Set the number of MOD samples that will be needed. (minus sample #0 which is special)
+	// ProTracker has room for 31 samples (plus sample #0 which is special)
+	if (mod_current_sound_index - 1 > kMaxSamples)
+	{
+		throw MODException(ModuleException::Category::kConvert, MOD::ConvertError::kTooManySamples);
+	}
 
-	// TODO: Check if there are too many samples needed here, and throw exception if so
+	mod_.total_mod_samples_ = mod_current_sound_index - 1; // Set the number of MOD samples that will be needed. (minus sample #0 which is special)
 
 	ConvertSampleData(sample_map);
 }
@@ -842,20 +912,14 @@ void MOD::DMFConverter::ConvertPatterns(const SampleMap& sample_map)
 			ApplyEffects(mod_row_data, mod_effects, global_effects);
 
 			// Set the channel rows for the current pattern row all at once
-			for (ChannelIndex channel = 0; channel < mod_data.GetNumChannels(); ++channel)
-			{
-				mod_data.SetRow(channel, dmf_order + kUsingSetupOrder, dmf_row, mod_row_data[channel]);
-			}
+			std::copy_n(mod_row_data.begin(), mod_data.GetNumChannels(), mod_data.GetRowSpan(dmf_order + kUsingSetupOrder, dmf_row));
 		}
 
 		// If the DMF has less than 64 rows per pattern, there will be extra MOD rows which will need to be blank; TODO: May not be needed
 		for (RowIndex dmf_row = dmf_num_rows; dmf_row < 64; ++dmf_row)
 		{
-			for (ChannelIndex channel = 0; channel < mod_data.GetNumChannels(); ++channel)
-			{
-				Row<MOD> temp_row_data{ 0, NoteTypes::Empty{}, { Effects::kNoEffect, 0 } };
-				mod_data.SetRow(channel, dmf_order + (int)kUsingSetupOrder, dmf_row, temp_row_data);
-			}
+			const Row<MOD> temp_row_data{ 0, NoteTypes::Empty{}, { Effects::kNoEffect, 0 } };
+			std::fill_n(mod_data.GetRowSpan(dmf_order + (int)kUsingSetupOrder, dmf_row), mod_data.GetNumChannels(), temp_row_data);
 		}
 	}
 }
@@ -926,7 +990,7 @@ auto MOD::DMFConverter::ConvertNote(ChannelStateReader<DMF>& state, NoteRange& n
 	}
 
 	NoteSlot dmf_note = state.Get<ChannelState<DMF>::kNoteSlot>();
-	switch (dmf_note.index())
+	switch (dmf_note.GetType())
 	{
 		// Convert note - Empty
 		case NoteTypes::kEmpty:
@@ -1148,165 +1212,197 @@ void MOD::DMFConverter::ConvertInitialBPM(unsigned& tempo, unsigned& speed)
 
 ///////// EXPORT /////////
 
+static constexpr std::size_t kHeaderSize = 20 + kMaxSamples * 30 + 2 + 128 + 4; // Module name, sample info, module info
+static constexpr std::size_t kCellSize = 4; // Bytes per channel per row in a pattern
+
+template<typename T>
+static inline void Put(std::byte*& out, T value)
+{
+	*out++ = static_cast<std::byte>(static_cast<std::uint8_t>(value));
+}
+
+static inline void PutPadded(std::byte*& out, std::string_view str, std::size_t length, char pad)
+{
+	assert(str.size() <= length);
+	if (!str.empty()) { std::memcpy(out, str.data(), str.size()); } // str.data() may be null, which memcpy doesn't allow
+	std::memset(out + str.size(), pad, length - str.size());
+	out += length;
+}
+
 void MOD::ExportImpl(const std::string& filename)
 {
+	std::vector<std::byte> buffer;
+	ExportImpl(buffer);
+
 	std::ofstream out_file(filename, std::ios::binary);
 	if (!out_file.is_open())
 	{
 		throw MODException(ModuleException::Category::kExport, ModuleException::ExportError::kFileOpen);
 	}
 
-	ExportModuleName(out_file);
-	ExportSampleInfo(out_file);
-	ExportModuleInfo(out_file);
-	ExportPatterns(out_file);
-	ExportSampleData(out_file);
-
+	out_file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
 	out_file.close();
 
 	const bool verbose = GlobalOptions::Get().GetOption(GlobalOptions::OptionEnum::kVerbose).GetValue<bool>();
 	if (verbose) { std::cout << "Saved MOD file to disk.\n\n"; }
 }
 
-void MOD::ExportModuleName(std::ofstream& fout) const
+auto MOD::GetExportSize() const -> std::size_t
 {
-	// Print module name, truncating or padding with zeros as needed
-	const auto title = GetTitle();
-	for (unsigned i = 0; i < 20; ++i)
+	assert(samples_.size() <= static_cast<std::size_t>(kMaxSamples) && "The header only has room for 31 samples");
+
+	const auto& mod_data = GetData();
+	std::size_t size = kHeaderSize + mod_data.PatternsRef().size() * kCellSize; // One cell per channel row
+	for (const auto& [discard, sample] : samples_)
 	{
-		if (i < title.size())
-		{
-			fout.put(title[i]);
-		}
-		else
-		{
-			fout.put(0);
-		}
+		size += sample.data.size();
 	}
+	return size;
 }
 
-void MOD::ExportSampleInfo(std::ofstream& fout) const
+void MOD::ExportImpl(std::vector<std::byte>& buffer)
+{
+	// The whole MOD file is serialized into one buffer of exactly the right size
+	buffer.resize(GetExportSize());
+
+	std::byte* out = buffer.data();
+	ExportModuleName(out);
+	ExportSampleInfo(out);
+	ExportModuleInfo(out);
+	ExportPatterns(out);
+	ExportSampleData(out);
+	assert(out == buffer.data() + buffer.size());
+}
+
+void MOD::ExportModuleName(std::byte*& out) const
+{
+	// Print module name, truncating or padding with zeros as needed
+	const std::string_view title = GetTitle();
+	PutPadded(out, title.substr(0, 20), 20, 0);
+}
+
+void MOD::ExportSampleInfo(std::byte*& out) const
 {
 	for (const auto& [discard, sample] : samples_)
 	{
 		if (sample.name.size() > 22) { throw std::length_error("Sample name must be 22 characters or less"); }
 
 		// Pad name with spaces
-		std::string name_copy = sample.name;
-		while (name_copy.size() < 22) { name_copy += " "; }
-
-		fout << name_copy;
-
-		fout.put(sample.length >> 9);       // Length byte 0
-		fout.put(sample.length >> 1);       // Length byte 1
-		fout.put(sample.finetune);          // Finetune value !!!
-		fout.put(sample.volume);            // Sample volume // TODO: Optimize this?
-		fout.put(sample.repeat_offset >> 9); // Repeat offset byte 0
-		fout.put(sample.repeat_offset >> 1); // Repeat offset byte 1
-		fout.put(sample.repeat_length >> 9); // Sample repeat length byte 0
-		fout.put(sample.repeat_length >> 1); // Sample repeat length byte 1
+		PutPadded(out, sample.name, 22, ' ');
+
+		Put(out, sample.length >> 9);        // Length byte 0
+		Put(out, sample.length >> 1);        // Length byte 1
+		Put(out, sample.finetune);           // Finetune value !!!
+		Put(out, sample.volume);             // Sample volume // TODO: Optimize this?
+		Put(out, sample.repeat_offset >> 9); // Repeat offset byte 0
+		Put(out, sample.repeat_offset >> 1); // Repeat offset byte 1
+		Put(out, sample.repeat_length >> 9); // Sample repeat length byte 0
+		Put(out, sample.repeat_length >> 1); // Sample repeat length byte 1
 	}
 
 	// The remaining samples are blank:
-	for (int i = total_mod_samples_; i < 31; ++i)
+	for (int i = total_mod_samples_; i < kMaxSamples; ++i)
 	{
-		if (i != 30)
+		if (i != kMaxSamples - 1)
 		{
 			// According to real ProTracker files viewed in a hex viewer, the 30th and final byte
 			//    of a blank sample is 0x01 and all 29 other bytes are 0x00.
-			for (int j = 0; j < 29; ++j)
-			{
-				fout.put(0);
-			}
-			fout.put(1);
+			PutPadded(out, {}, 29, 0);
+			Put(out, 1);
 		}
 		else
 		{
-			// Print credits message in last sample's name
-			std::string credits = "Made with dmf2mod";
-
-			// Pad name with spaces
-			while (credits.size() < 22) { credits += " "; }
-
-			fout << credits;
-
-			for (int j = 22; j < 29; ++j)
-			{
-				fout.put(0);
-			}
-			fout.put(1);
+			// Print credits message in last sample's name, padded with spaces
+			PutPadded(out, "Made with dmf2mod", 22, ' ');
+			PutPadded(out, {}, 29 - 22, 0);
+			Put(out, 1);
 		}
 	}
 }
 
-void MOD::ExportModuleInfo(std::ofstream& fout) const
+void MOD::ExportModuleInfo(std::byte*& out) const
 {
 	const auto num_orders = static_cast<std::uint8_t>(GetData().GetNumOrders());
 
-	fout.put(num_orders); // Song length in patterns (not total number of patterns)
-	fout.put(127);        // 0x7F - Useless byte that has to be here
+	Put(out, num_orders); // Song length in patterns (not total number of patterns)
+	Put(out, 127);        // 0x7F - Useless byte that has to be here
 
 	// Pattern matrix (Each ProTracker pattern number is the same as its pattern matrix row number)
 	for (PatternIndex pattern_id : GetData().PatternMatrixRef())
 	{
-		fout.put(static_cast<std::uint8_t>(pattern_id));
+		Put(out, pattern_id);
 	}
 	for (uint8_t i = num_orders; i < 128; ++i)
 	{
-		fout.put(0);
+		Put(out, 0);
 	}
 
-	fout << "M.K."; // ProTracker uses "M!K!" if there's more than 64 pattern matrix rows
+	PutPadded(out, "M.K.", 4, 0); // ProTracker uses "M!K!" if there's more than 64 pattern matrix rows
 }
 
-void MOD::ExportPatterns(std::ofstream& fout) const
+/*
+ * Packs count pattern cells into 4 bytes each:
+ * [sample (upper 4b)][period (upper 4b)] [period (lower 8b)] [sample (lower 4b)][effect code (upper 4b)] [effect (lower 8b)]
+ * Every cell is independent and branch-free, so compilers vectorize this loop.
+ */
+static void PackPatternCells(const std::uint16_t* periods, const std::uint8_t* samples, const std::uint16_t* effects, std::size_t count, std::byte* out)
 {
-	const auto& mod_data = GetData();
-	for (const auto& pattern : mod_data.PatternsRef())
+	auto* cells = reinterpret_cast<std::uint8_t*>(out);
+	for (std::size_t i = 0; i < count; ++i)
 	{
-		for (RowIndex row = 0; row < mod_data.GetNumRows(); ++row)
-		{
-			for (ChannelIndex channel = 0; channel < mod_data.GetNumChannels(); ++channel)
-			{
-				const Row<MOD>& row_data = pattern[row][channel];
-				uint16_t period = 0;
-				if (NoteHasPitch(row_data.note))
-				{
-					const std::uint8_t octave = GetNote(row_data.note).octave;
-					const auto pitch = static_cast<std::uint8_t>(GetNote(row_data.note).pitch);
-					period = kProTrackerPeriodTable[octave][pitch];
-				}
+		cells[4 * i]     = static_cast<std::uint8_t>((samples[i] & 0xF0) | ((periods[i] >> 8) & 0x0F));
+		cells[4 * i + 1] = static_cast<std::uint8_t>(periods[i] & 0xFF);
+		cells[4 * i + 2] = static_cast<std::uint8_t>((samples[i] << 4) | ((effects[i] >> 8) & 0x0F));
+		cells[4 * i + 3] = static_cast<std::uint8_t>(effects[i] & 0xFF);
+	}
+}
 
-				// Sample number (upper 4b); sample period/effect param. (lower 4b)
-				fout.put((row_data.sample & 0xF0) | ((period & 0x0F00) >> 8));
+void MOD::ExportPatterns(std::byte*& out) const
+{
+	const auto& mod_data = GetData();
+	const std::size_t num_cells = static_cast<std::size_t>(mod_data.GetNumRows()) * mod_data.GetNumChannels();
 
-				// Sample period/effect param. (lower 8 bits)
-				fout.put(period & 0x00FF);
+	// Each pattern is first flattened into arrays of periods, samples and 12-bit effects (MOD effect code + value),
+	// in file order (row-major), then packed into cells all at once
+	std::vector<std::uint16_t> periods(num_cells);
+	std::vector<std::uint8_t> samples(num_cells);
+	std::vector<std::uint16_t> effects(num_cells);
 
-				//const std::uint16_t effect = ((uint16_t)rowData.EffectCode << 4) | rowData.EffectValue;
+	// Pattern storage is already in file order, so each pattern is one contiguous run of cells
+	for (PatternIndex pattern_id = 0; pattern_id < mod_data.GetNumPatterns(); ++pattern_id)
+	{
+		const Row<MOD>* pattern = mod_data.GetPatternById(pattern_id);
+		for (std::size_t cell = 0; cell < num_cells; ++cell)
+		{
+			const Row<MOD>& row_data = pattern[cell];
 
-				// Convert dmf2mod internal effect code to MOD effect code
-				const std::uint8_t effect_code = GetEffectCode(row_data.effect.code);
+			periods[cell] = 0;
+			if (NoteHasPitch(row_data.note))
+			{
+				const std::uint8_t octave = GetNote(row_data.note).octave;
+				const auto pitch = static_cast<std::uint8_t>(GetNote(row_data.note).pitch);
+				periods[cell] = kProTrackerPeriodTable[octave][pitch];
+			}
 
-				// Sample number (lower 4b); effect code (upper 4b)
-				fout.put((row_data.sample << 4) | (effect_code >> 4));
+			samples[cell] = static_cast<std::uint8_t>(row_data.sample);
 
-				// Effect code (lower 8 bits)
-				fout.put(((effect_code << 4) & 0x00FF) | static_cast<std::uint8_t>(row_data.effect.value));
-			}
+			// Convert dmf2mod internal effect code to MOD effect code
+			const std::int16_t effect_code = kEffectCodeTable[static_cast<std::uint8_t>(row_data.effect.code)];
+			assert(effect_code >= 0 && "Unsupported effect");
+			effects[cell] = static_cast<std::uint16_t>((std::max<std::int16_t>(effect_code, 0) << 4) | static_cast<std::uint8_t>(row_data.effect.value));
 		}
+
+		PackPatternCells(periods.data(), samples.data(), effects.data(), num_cells, out);
+		out += num_cells * kCellSize;
 	}
 }
 
-void MOD::ExportSampleData(std::ofstream& fout) const
+void MOD::ExportSampleData(std::byte*& out) const
 {
-	for (const auto& sample_info : samples_)
+	for (const auto& [discard, sample] : samples_)
 	{
-		const auto& sample_data = sample_info.second.data;
-		for (std::int8_t value : sample_data)
-		{
-			fout.put(value);
-		}
+		std::memcpy(out, sample.data.data(), sample.data.size());
+		out += sample.data.size();
 	}
 }
 
@@ -1381,88 +1477,6 @@ static auto GenerateWavetableSample(uint32_t* wavetable_data, unsigned length) -
 	return sample;
 }
 
-static auto GetEffectCode(int effect_code) -> std::uint8_t
-{
-	// Maps dmf2mod internal effect code to MOD effect code.
-	switch (effect_code)
-	{
-		// Common effects:
-		case d2m::Effects::kNoEffect:
-			return mod::EffectCode::kNoEffect;
-		case d2m::Effects::kArp:
-			return mod::EffectCode::kArp;
-		case d2m::Effects::kPortUp:
-			return mod::EffectCode::kPortUp;
-		case d2m::Effects::kPortDown:
-			return mod::EffectCode::kPortDown;
-		case d2m::Effects::kPort2Note:
-			return mod::EffectCode::kPort2Note;
-		case d2m::Effects::kVibrato:
-			return mod::EffectCode::kVibrato;
-		case d2m::Effects::kPort2NoteVolSlide:
-			return mod::EffectCode::kPort2NoteVolSlide;
-		case d2m::Effects::kVibratoVolSlide:
-			return mod::EffectCode::kVibratoVolSlide;
-		case d2m::Effects::kTremolo:
-			return mod::EffectCode::kTremolo;
-		case d2m::Effects::kPanning:
-			return mod::EffectCode::kPanning;
-		case d2m::Effects::kSpeedA:
-			return mod::EffectCode::kSetSpeed;
-		case d2m::Effects::kVolSlide:
-			return mod::EffectCode::kVolSlide;
-		case d2m::Effects::kPosJump:
-			return mod::EffectCode::kPosJump;
-		case d2m::Effects::kRetrigger:
-			return mod::EffectCode::kRetriggerSample;
-		case d2m::Effects::kPatBreak:
-			return mod::EffectCode::kPatBreak;
-		case d2m::Effects::kNoteCut:
-			return mod::EffectCode::kCutSample;
-		case d2m::Effects::kNoteDelay:
-			return mod::EffectCode::kDelaySample;
-		case d2m::Effects::kTempo:
-			return mod::EffectCode::kSetSpeed; // Same as kSpeedA, but different effect values are used
-		case d2m::Effects::kSpeedB:
-			assert(false && "Unsupported effect");
-			return mod::EffectCode::kNoEffect;
-
-		// ProTracker-specific effects:
-		case mod::Effects::kSetSampleOffset:
-			return mod::EffectCode::kSetSampleOffset;
-		case mod::Effects::kSetVolume:
-			return mod::EffectCode::kSetVolume;
-		case mod::Effects::kSetFilter:
-			return mod::EffectCode::kSetFilter;
-		case mod::Effects::kFineSlideUp:
-			return mod::EffectCode::kFineSlideUp;
-		case mod::Effects::kFineSlideDown:
-			return mod::EffectCode::kFineSlideDown;
-		case mod::Effects::kSetGlissando:
-			return mod::EffectCode::kSetGlissando;
-		case mod::Effects::kSetVibratoWaveform:
-			return mod::EffectCode::kSetVibratoWaveform;
-		case mod::Effects::kSetFinetune:
-			return mod::EffectCode::kSetFinetune;
-		case mod::Effects::kLoopPattern:
-			return mod::EffectCode::kLoopPattern;
-		case mod::Effects::kSetTremoloWaveform:
-			return mod::EffectCode::kSetTremoloWaveform;
-		case mod::Effects::kFineVolSlideUp:
-			return mod::EffectCode::kFineVolSlideUp;
-		case mod::Effects::kFineVolSlideDown:
-			return mod::EffectCode::kFineVolSlideDown;
-		case mod::Effects::kDelayPattern:
-			return mod::EffectCode::kDelayPattern;
-		case mod::Effects::kInvertLoop:
-			return mod::EffectCode::kInvertLoop;
-
-		default:
-			assert(false && "Unknown effect");
-			return mod::EffectCode::kNoEffect;
-	}
-}
-
 static auto GetWarningMessage(MOD::ConvertWarning warning, const std::string& info) -> std::string
 {
 	switch (warning)
@@ -1515,6 +1529,8 @@ auto MODException::CreateErrorMessage(Category category, int error_code, std::st
 					return "Only the Game Boy system is currently supported.";
 				case (int)MOD::ConvertError::kTooManyPatternMatrixRows:
 					return "Too many rows of patterns in the pattern matrix. 64 is the maximum. (63 if using Setup Pattern.)";
+				case (int)MOD::ConvertError::kTooManySamples:
+					return "Too many samples are needed. 31 is the maximum.";
 				case (int)MOD::ConvertError::kOver64RowPattern:
 					return "Patterns must have 64 or fewer rows.\n"
 							"       A workaround for this issue is planned for a future update to dmf2mod.";
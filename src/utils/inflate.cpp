@@ -0,0 +1,122 @@
+/*
+ * inflate.cpp
+ * Written by Dalton Messmer <messmer.dalton@gmail.com>.
+ *
+ * See inflate.h
+ */
+
+#include "utils/inflate.h"
+
+#include "utils/stream_reader.h"
+
+#include <zstr.hpp>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace d2m {
+
+static constexpr std::size_t kStreamingChunkSize = 0x10000; // The streaming backend inflates this many bytes at a time
+static constexpr std::size_t kOneShotSizeEstimate = 8; // The one-shot backend first assumes a compression ratio this high
+static constexpr std::size_t kOneShotMinSize = 0x10000;
+
+// Same check zstr uses to decide whether data is compressed
+static auto HasCompressionHeader(const void* data, std::size_t size) -> bool
+{
+	if (size < 2) { return false; }
+	const auto* bytes = static_cast<const std::uint8_t*>(data);
+	return (bytes[0] == 0x1F && bytes[1] == 0x8B) // gzip
+		|| (bytes[0] == 0x78 && (bytes[1] == 0x01 || bytes[1] == 0x9C || bytes[1] == 0xDA)); // zlib
+}
+
+static auto InflateStreaming(const void* data, std::size_t size) -> std::vector<char>
+{
+	auto source = MemoryStreamBuffer{data, size};
+	std::vector<char> buffer;
+	std::size_t buffer_size = 0;
+	try
+	{
+		// zstr passes uncompressed data through unchanged
+		zstr::istream stream{&source};
+		do
+		{
+			buffer.resize(buffer_size + kStreamingChunkSize);
+			stream.read(buffer.data() + buffer_size, kStreamingChunkSize);
+			buffer_size += static_cast<std::size_t>(stream.gcount());
+		} while (stream);
+	}
+	catch (const zstr::Exception& e)
+	{
+		throw InflateError{e.what()};
+	}
+
+	buffer.resize(buffer_size);
+	return buffer;
+}
+
+static auto InflateOneShot(const void* data, std::size_t size) -> std::vector<char>
+{
+	if (!HasCompressionHeader(data, size))
+	{
+		const auto* bytes = static_cast<const char*>(data);
+		return std::vector<char>(bytes, bytes + size);
+	}
+
+	z_stream zstream{};
+	if (inflateInit2(&zstream, 15 + 32) != Z_OK) // Detect zlib or gzip header
+	{
+		throw InflateError{"zlib error: failed to initialize"};
+	}
+
+	// zlib doesn't store the inflated size, so start with an estimate and grow the buffer only if needed
+	std::vector<char> buffer(std::max(size * kOneShotSizeEstimate, kOneShotMinSize));
+
+	zstream.next_in = reinterpret_cast<Bytef*>(const_cast<void*>(data)); // zlib never writes to the input
+	std::size_t input_left = size;
+	int result = Z_OK;
+	while (true)
+	{
+		// avail_in and avail_out are 32-bit, so huge buffers are fed to zlib in pieces
+		constexpr std::size_t kMaxAvail = std::numeric_limits<uInt>::max();
+		const std::size_t input_step = std::min(input_left, kMaxAvail - zstream.avail_in);
+		zstream.avail_in += static_cast<uInt>(input_step);
+		input_left -= input_step;
+
+		if (zstream.total_out == buffer.size())
+		{
+			buffer.resize(buffer.size() * 2);
+		}
+		zstream.next_out = reinterpret_cast<Bytef*>(buffer.data() + zstream.total_out);
+		zstream.avail_out = static_cast<uInt>(std::min(buffer.size() - zstream.total_out, kMaxAvail));
+
+		result = inflate(&zstream, Z_FINISH);
+		if (result == Z_STREAM_END) { break; }
+		if (result == Z_BUF_ERROR || result == Z_OK)
+		{
+			if (zstream.avail_out == 0 || input_left > 0) { continue; } // Needs more room or more input
+			break; // The compressed data ended early
+		}
+
+		const std::string message = zstream.msg ? zstream.msg : "unknown error";
+		inflateEnd(&zstream);
+		throw InflateError{"zlib error: " + message};
+	}
+
+	buffer.resize(zstream.total_out);
+	inflateEnd(&zstream);
+	return buffer;
+}
+
+auto Inflate(const void* data, std::size_t size, InflateBackend backend) -> std::vector<char>
+{
+	switch (backend)
+	{
+		case InflateBackend::kStreaming: return InflateStreaming(data, size);
+		case InflateBackend::kOneShot: return InflateOneShot(data, size);
+		default: throw InflateError{"Invalid inflate backend"};
+	}
+}
+
+} // namespace d2m
@@ -0,0 +1,157 @@
+/*
+ * mapped_file.cpp
+ * Written by Dalton Messmer <messmer.dalton@gmail.com>.
+ *
+ * See mapped_file.h
+ */
+
+#include "utils/mapped_file.h"
+
+#include <fstream>
+#include <iterator>
+
+#if defined(_WIN32)
+	#define D2M_MAPPED_FILE_WINDOWS
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+	#define D2M_MAPPED_FILE_POSIX
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace d2m {
+
+auto MappedFile::Open(const std::string& filename) -> bool
+{
+	Close();
+
+#if defined(D2M_MAPPED_FILE_POSIX)
+	const int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd == -1) { return false; }
+
+	struct stat info;
+	if (::fstat(fd, &info) != 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	if (!S_ISREG(info.st_mode))
+	{
+		// Pipes, devices, etc. can't be mapped
+		::close(fd);
+		return ReadIntoBuffer(filename);
+	}
+
+	size_ = static_cast<std::size_t>(info.st_size);
+	if (size_ == 0)
+	{
+		// mmap doesn't accept a length of zero
+		::close(fd);
+		open_ = true;
+		return true;
+	}
+
+	void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // The mapping stays valid after the descriptor is closed
+	if (addr == MAP_FAILED)
+	{
+		size_ = 0;
+		return ReadIntoBuffer(filename);
+	}
+
+	::madvise(addr, size_, MADV_SEQUENTIAL);
+
+	data_ = static_cast<const char*>(addr);
+	open_ = true;
+	mapped_ = true;
+	return true;
+
+#elif defined(D2M_MAPPED_FILE_WINDOWS)
+	HANDLE file = ::CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) { return false; }
+
+	LARGE_INTEGER file_size;
+	if (!::GetFileSizeEx(file, &file_size))
+	{
+		::CloseHandle(file);
+		return false;
+	}
+
+	size_ = static_cast<std::size_t>(file_size.QuadPart);
+	if (size_ == 0)
+	{
+		// Empty files can't be mapped
+		::CloseHandle(file);
+		open_ = true;
+		return true;
+	}
+
+	HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	::CloseHandle(file); // The mapping keeps the file open
+	if (!mapping)
+	{
+		size_ = 0;
+		return ReadIntoBuffer(filename);
+	}
+
+	void* addr = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(mapping); // The view keeps the mapping alive
+	if (!addr)
+	{
+		size_ = 0;
+		return ReadIntoBuffer(filename);
+	}
+
+	data_ = static_cast<const char*>(addr);
+	open_ = true;
+	mapped_ = true;
+	return true;
+
+#else
+	return ReadIntoBuffer(filename);
+#endif
+}
+
+void MappedFile::Close()
+{
+	if (mapped_)
+	{
+#if defined(D2M_MAPPED_FILE_POSIX)
+		::munmap(const_cast<char*>(data_), size_);
+#elif defined(D2M_MAPPED_FILE_WINDOWS)
+		::UnmapViewOfFile(data_);
+#endif
+	}
+
+	buffer_.clear();
+	buffer_.shrink_to_fit();
+	data_ = nullptr;
+	size_ = 0;
+	open_ = false;
+	mapped_ = false;
+}
+
+auto MappedFile::ReadIntoBuffer(const std::string& filename) -> bool
+{
+	std::ifstream file{filename, std::ios_base::in | std::ios_base::binary};
+	if (!file) { return false; }
+
+	buffer_.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+	if (file.bad()) { return false; }
+
+	data_ = buffer_.empty() ? nullptr : buffer_.data();
+	size_ = buffer_.size();
+	open_ = true;
+	return true;
+}
+
+} // namespace d2m
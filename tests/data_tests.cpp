@@ -0,0 +1,239 @@
+/*
+ * data_tests.cpp
+ * Written by Dalton Messmer <messmer.dalton@gmail.com>.
+ *
+ * Tests for ModuleData storage.
+ * Returns a non-zero exit code if any check fails.
+ */
+
+#include "modules/dmf.h"
+
+#include <iostream>
+#include <tuple>
+
+using namespace d2m;
+
+/*
+ * A minimal module with kColumnar storage, so the columnar layout is tested no matter
+ * which storage DMF is built with
+ */
+struct ColumnarModule;
+
+namespace d2m {
+
+template<>
+struct ModuleGlobalData<ColumnarModule> : public ModuleGlobalDataDefault<DataStorageType::kColumnar> {};
+
+template<>
+struct Row<ColumnarModule> : public RowDefault
+{
+	std::int16_t volume;
+	Effect effect;
+};
+
+template<>
+struct RowColumns<ColumnarModule>
+{
+	enum Column { kNote, kVolume, kEffect };
+
+	using Types = std::tuple<NoteSlot, std::int16_t, Effect>;
+
+	static auto Split(const Row<ColumnarModule>& row) -> Types { return {row.note, row.volume, row.effect}; }
+
+	static auto Join(const Types& columns) -> Row<ColumnarModule>
+	{
+		Row<ColumnarModule> row;
+		std::tie(row.note, row.volume, row.effect) = columns;
+		return row;
+	}
+};
+
+} // namespace d2m
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const char* what)
+{
+	if (condition) { return; }
+	std::cerr << "FAILED: " << what << "\n";
+	++failures;
+}
+
+#define CHECK(condition) Check((condition), #condition)
+
+// The pooling tests need DMF's default kPacked storage (see the DMF_STORAGE CMake option)
+#ifndef DMF2MOD_DMF_COLUMNAR
+
+auto MakeRow(std::int16_t volume) -> Row<DMF>
+{
+	Row<DMF> row{};
+	row.note = Note{NotePitch::kC, 3};
+	row.volume = volume;
+	row.instrument = -1;
+	row.effect[0] = {Effects::kNoEffect, 0};
+	return row;
+}
+
+/*
+ * Channel 0 uses patterns 0, 1, 0; channel 1 uses patterns 0, 1, 2.
+ * Both channels have one effects column, so the same rows pack the same way in either channel.
+ */
+void InitData(ModuleData<DMF>& data)
+{
+	constexpr RowIndex kRows = 4;
+	data.AllocatePatternMatrix(2, 3, kRows);
+	data.SetPatternId(0, 0, 0); data.SetPatternId(0, 1, 1); data.SetPatternId(0, 2, 0);
+	data.SetPatternId(1, 0, 0); data.SetPatternId(1, 1, 1); data.SetPatternId(1, 2, 2);
+	data.AllocateChannels();
+	data.AllocatePatterns();
+	data.SetChannelMetadata(0, {1});
+	data.SetChannelMetadata(1, {1});
+
+	for (RowIndex row = 0; row < kRows; ++row)
+	{
+		// Pattern 0 of each channel and pattern 2 of channel 1 have identical rows
+		data.SetRowById(0, 0, row, MakeRow(row));
+		data.SetRowById(0, 1, row, MakeRow(10 + row));
+		data.SetRowById(1, 0, row, MakeRow(row));
+		data.SetRowById(1, 1, row, MakeRow(20 + row));
+		data.SetRowById(1, 2, row, MakeRow(row));
+	}
+}
+
+void TestPooling()
+{
+	ModuleData<DMF> data;
+	InitData(data);
+	CHECK(data.GetNumPatternBlocks() == 5);
+
+	data.PoolPatterns();
+	CHECK(data.GetNumPatternBlocks() == 3);
+	CHECK(data.GetPatternBlock(0, 0) == data.GetPatternBlock(1, 0));
+	CHECK(data.GetPatternBlock(0, 0) == data.GetPatternBlock(1, 2));
+	CHECK(data.GetPatternBlock(0, 1) != data.GetPatternBlock(1, 1));
+	CHECK(data.GetPatternHash(0, 0) == data.GetPatternHash(1, 2));
+	CHECK(data.PatternsRef().size() == 3 * 4 * data.GetPackedRowSize(0));
+
+	// Rows read back unchanged
+	CHECK(data.GetRowById(1, 2, 3).volume == 3);
+	CHECK(data.GetRow(0, 2, 1).volume == 1);
+	CHECK(data.GetRowById(1, 1, 2).volume == 22);
+}
+
+void TestCopyOnWrite()
+{
+	ModuleData<DMF> data;
+	InitData(data);
+	data.PoolPatterns();
+
+	const std::size_t shared_hash = data.GetPatternHash(1, 2);
+	const std::size_t other_hash = data.GetPatternHash(0, 1);
+
+	// Writing to a shared pattern gives it its own block and leaves the others alone
+	data.SetRowById(1, 2, 0, MakeRow(99));
+	CHECK(data.GetNumPatternBlocks() == 4);
+	CHECK(data.GetPatternBlock(1, 2) != data.GetPatternBlock(0, 0));
+	CHECK(data.GetPatternBlock(0, 0) == data.GetPatternBlock(1, 0));
+	CHECK(data.GetRowById(1, 2, 0).volume == 99);
+	CHECK(data.GetRowById(0, 0, 0).volume == 0);
+	CHECK(data.GetRowById(1, 0, 0).volume == 0);
+
+	// The hash follows the rows
+	CHECK(data.GetPatternHash(1, 2) != shared_hash);
+	CHECK(data.GetPatternHash(0, 0) == shared_hash);
+
+	// Writing to a pattern which isn't shared doesn't copy it, but still changes its hash
+	const std::size_t block = data.GetPatternBlock(0, 1);
+	data.SetRowById(0, 1, 3, MakeRow(98));
+	CHECK(data.GetPatternBlock(0, 1) == block);
+	CHECK(data.GetNumPatternBlocks() == 4);
+	CHECK(data.GetPatternHash(0, 1) != other_hash);
+
+	// Writing back the original rows gives back the original hashes
+	data.SetRowById(1, 2, 0, MakeRow(0));
+	data.SetRowById(0, 1, 3, MakeRow(13));
+	CHECK(data.GetPatternHash(1, 2) == shared_hash);
+	CHECK(data.GetPatternHash(0, 1) == other_hash);
+
+	// Pooling again merges them back together and compacts the rows
+	data.PoolPatterns();
+	CHECK(data.GetNumPatternBlocks() == 3);
+	CHECK(data.GetPatternBlock(1, 2) == data.GetPatternBlock(0, 0));
+	CHECK(data.PatternsRef().size() == 3 * 4 * data.GetPackedRowSize(0));
+}
+
+#endif // DMF2MOD_DMF_COLUMNAR
+
+auto MakeColumnarRow(NoteSlot note, int volume, Effect effect) -> Row<ColumnarModule>
+{
+	Row<ColumnarModule> row{};
+	row.note = note;
+	row.volume = static_cast<std::int16_t>(volume);
+	row.effect = effect;
+	return row;
+}
+
+/*
+ * Two channels with 2 orders of 3 rows. Channel 0 uses patterns 0, 1; channel 1 uses pattern 0 twice.
+ */
+void TestColumns()
+{
+	using Columns = RowColumns<ColumnarModule>;
+
+	ModuleData<ColumnarModule> data;
+	data.AllocatePatternMatrix(2, 2, 3);
+	data.SetPatternId(0, 0, 0); data.SetPatternId(0, 1, 1);
+	data.SetPatternId(1, 0, 0); data.SetPatternId(1, 1, 0);
+	data.AllocateChannels();
+	data.AllocatePatterns();
+	CHECK(data.GetNumPatterns(0) == 2);
+	CHECK(data.GetNumPatterns(1) == 1);
+
+	// New rows are value-initialized
+	CHECK(NoteIsEmpty(data.GetRow(1, 1, 2).note));
+	CHECK(data.GetRow(1, 1, 2).volume == 0);
+
+	for (RowIndex row = 0; row < 3; ++row)
+	{
+		const auto value = static_cast<std::int16_t>(row);
+		data.SetRowById(0, 0, row, MakeColumnarRow(Note{NotePitch::kC, 3}, value, {Effects::kNoEffect, 0}));
+		data.SetRowById(0, 1, row, MakeColumnarRow(Note{NotePitch::kD, 4}, 10 + value, {Effects::kPosJump, value}));
+		data.SetRow(1, 0, row, MakeColumnarRow(NoteTypes::Off{}, 20 + value, {Effects::kPatBreak, 0}));
+	}
+
+	// Rows are joined back together from the columns
+	const auto row = data.GetRow(0, 1, 2);
+	CHECK(row.note == NoteSlot(Note(NotePitch::kD, 4)));
+	CHECK(row.volume == 12);
+	CHECK(row.effect.code == Effects::kPosJump && row.effect.value == 2);
+	CHECK(data.GetRowById(1, 0, 1).volume == 21);
+
+	// A pattern's column is contiguous, and order 1 of channel 1 reads pattern 0's column
+	const std::int16_t* volumes = data.GetColumn<Columns::kVolume>(0, 1);
+	CHECK(volumes[0] == 10 && volumes[1] == 11 && volumes[2] == 12);
+	CHECK(data.GetColumn<Columns::kEffect>(1, 1) == data.GetColumnById<Columns::kEffect>(1, 0));
+	CHECK(data.GetColumn<Columns::kEffect>(1, 1)[2].code == Effects::kPatBreak);
+	CHECK(NoteIsOff(data.GetColumn<Columns::kNote>(1, 0)[0]));
+	CHECK(data.GetColumn<Columns::kNote>(0, 0)[1] == NoteSlot(Note(NotePitch::kC, 3)));
+}
+
+} // namespace
+
+auto main() -> int
+{
+#ifndef DMF2MOD_DMF_COLUMNAR
+	TestPooling();
+	TestCopyOnWrite();
+#endif
+	TestColumns();
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " check(s) failed\n";
+		return 1;
+	}
+	std::cout << "All data tests passed\n";
+	return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * dmf_import_tests.cpp
+ * Written by Dalton Messmer <messmer.dalton@gmail.com>.
+ *
+ * Tests for importing DMF files, including malformed ones.
+ * Returns a non-zero exit code if any check fails.
+ */
+
+#include "dmf2mod.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace d2m;
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const char* what)
+{
+	if (condition) { return; }
+	std::cerr << "FAILED: " << what << "\n";
+	++failures;
+}
+
+#define CHECK(condition) Check((condition), #condition)
+
+constexpr std::uint8_t kNumChannels = 4; // Game Boy
+constexpr std::uint8_t kNumOrders = 20;
+constexpr std::uint32_t kNumRows = 64;
+constexpr std::uint8_t kEffectColumns = 4;
+
+void Put16(std::vector<char>& file, std::int16_t value)
+{
+	file.push_back(static_cast<char>(value & 0xFF));
+	file.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+/*
+ * Builds an uncompressed version 27 Game Boy DMF file with empty patterns and no instruments,
+ * wavetables, or PCM samples. channel_block_ends[channel] is set to the size of the file
+ * up to and including the channel's pattern data.
+ */
+auto MakeDMF(std::vector<std::size_t>& channel_block_ends) -> std::vector<char>
+{
+	const std::string header = ".DelekDefleMask.";
+	std::vector<char> file{header.begin(), header.end()};
+	file.push_back(27); // DMF version
+	file.push_back(0x04); // Game Boy
+
+	file.push_back(0); // Title
+	file.push_back(0); // Author
+	file.push_back(4); // Highlight A
+	file.push_back(16); // Highlight B
+
+	file.push_back(0); // Time base
+	file.push_back(6); // Tick time 1
+	file.push_back(6); // Tick time 2
+	file.push_back(1); // Frames mode
+	file.push_back(0); // Using custom Hz
+	file.insert(file.end(), 3, '\0'); // Custom Hz
+	for (int i = 0; i < 4; ++i) { file.push_back(static_cast<char>((kNumRows >> (8 * i)) & 0xFF)); }
+	file.push_back(kNumOrders);
+
+	// Pattern matrix
+	for (std::uint8_t channel = 0; channel < kNumChannels; ++channel)
+	{
+		for (std::uint8_t order = 0; order < kNumOrders; ++order)
+		{
+			file.push_back(static_cast<char>(order)); // Pattern ID
+			file.push_back(0); // Pattern name
+		}
+	}
+
+	file.push_back(0); // Instruments
+	file.push_back(0); // Wavetables
+
+	channel_block_ends.clear();
+	for (std::uint8_t channel = 0; channel < kNumChannels; ++channel)
+	{
+		file.push_back(kEffectColumns);
+		for (std::uint32_t row = 0; row < kNumOrders * kNumRows; ++row)
+		{
+			Put16(file, 0); // Pitch
+			Put16(file, 0); // Octave
+			Put16(file, -1); // Volume
+			for (std::uint8_t col = 0; col < kEffectColumns; ++col)
+			{
+				Put16(file, -1); // Effect code
+				Put16(file, -1); // Effect value
+			}
+			Put16(file, -1); // Instrument
+		}
+		channel_block_ends.push_back(file.size());
+	}
+
+	file.push_back(0); // PCM samples
+	return file;
+}
+
+auto ImportDMF(const std::vector<char>& file, std::size_t size, DMF::ImportMode mode) -> bool
+{
+	auto dmf = Factory<ModuleBase>::Create<DMF>();
+	dmf->SetImportMode(mode);
+	return !dmf->Import(file.data(), size);
+}
+
+void TestComplete()
+{
+	std::vector<std::size_t> channel_block_ends;
+	const auto file = MakeDMF(channel_block_ends);
+
+	CHECK(ImportDMF(file, file.size(), DMF::ImportMode::kBuffered));
+	CHECK(ImportDMF(file, file.size(), DMF::ImportMode::kStreaming));
+}
+
+// A file which ends right after a channel's patterns must be reported as truncated, not decoded in parallel
+void TestTruncatedAtChannelBlock()
+{
+	std::vector<std::size_t> channel_block_ends;
+	const auto file = MakeDMF(channel_block_ends);
+
+	for (std::size_t channel = 0; channel + 1 < kNumChannels; ++channel)
+	{
+		const std::size_t size = channel_block_ends[channel];
+		CHECK(!ImportDMF(file, size, DMF::ImportMode::kBuffered));
+		CHECK(!ImportDMF(file, size + 1, DMF::ImportMode::kBuffered));
+		CHECK(!ImportDMF(file, size, DMF::ImportMode::kStreaming));
+	}
+
+	// Missing only the PCM samples count
+	CHECK(!ImportDMF(file, channel_block_ends.back(), DMF::ImportMode::kBuffered));
+}
+
+} // namespace
+
+auto main() -> int
+{
+	TestComplete();
+	TestTruncatedAtChannelBlock();
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " check(s) failed\n";
+		return 1;
+	}
+	std::cout << "All DMF import tests passed\n";
+	return 0;
+}
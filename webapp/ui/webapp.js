@@ -193,20 +193,14 @@ function getOptions() {
   return vo;
 }
 
-async function importFileLocal(externalFile, internalFilename) {
+// Returns the file's contents, which dmf2mod can import directly without going through the file system
+async function readFileLocal(externalFile) {
   if (!appInitialised) {
-    return true;
+    return null;
   }
 
   // Convert blob to Uint8Array (more abstract: ArrayBufferView)
-  let data = new Uint8Array(await externalFile.arrayBuffer());
-
-  // Store the file
-  let stream = FS.open(internalFilename, "w+");
-  FS.write(stream, data, 0, data.length, 0);
-  FS.close(stream);
-
-  return false;
+  return new Uint8Array(await externalFile.arrayBuffer());
 }
 
 // From: https://stackoverflow.com/questions/63959571/how-do-i-pass-a-file-blob-from-javascript-to-emscripten-webassembly-c
@@ -276,22 +270,19 @@ async function convertFile() {
     return true;
   }
 
-  let resp = await importFileLocal(externalFile, internalFilenameInput);
-  if (resp) {
+  const inputData = await readFileLocal(externalFile);
+  if (!inputData) {
     disableControls(false);
     return true;
   }
 
-  resp = Module.moduleImport(internalFilenameInput);
+  let resp = Module.moduleImport(internalFilenameInput, inputData);
   setStatusMessage();
   if (resp) {
     disableControls(false);
     return true;
   }
 
-  let stream = FS.open(internalFilenameOutput, "w+");
-  FS.close(stream);
-
   const result = Module.moduleConvert(internalFilenameOutput, options);
   setStatusMessage();
   if (result) {
@@ -299,7 +290,8 @@ async function convertFile() {
     return true;
   }
 
-  const byteArray = FS.readFile(internalFilenameOutput);
+  // Copy the output out of the WebAssembly heap
+  const byteArray = Module.getOutputData().slice();
   const blob = new Blob([byteArray]);
 
   let a = document.createElement("a");
@@ -10,7 +10,9 @@
 #include <emscripten/bind.h>
 #include <emscripten/emscripten.h>
 
+#include <cstddef>
 #include <iostream>
+#include <vector>
 
 using namespace d2m;
 
@@ -18,6 +20,7 @@ using namespace d2m;
 
 static ModulePtr kModule;
 static std::string kInputFilename;
+static std::vector<std::byte> kOutputData; // The last converted module file
 
 struct OptionDefinitionWrapper
 {
@@ -94,10 +97,10 @@ auto GetOptionDefinitionsWrapper(int module_type) -> std::vector<OptionDefinitio
 }
 
 /*
- * Imports and stores module from specified filename
+ * Imports and stores module from the file contents in data. The filename is only used to determine the module type.
  * Returns true upon failure
  */
-auto ModuleImport(std::string filename) -> bool
+auto ModuleImport(std::string filename, std::string data) -> bool
 {
 	SetStatusType(true);
 
@@ -118,7 +121,7 @@ auto ModuleImport(std::string filename) -> bool
 		return true;
 	}
 
-	kModule->Import(filename);
+	kModule->Import(data.data(), data.size());
 
 	if (kModule->GetStatus().ErrorOccurred())
 	{
@@ -139,6 +142,7 @@ auto ModuleImport(std::string filename) -> bool
 
 /*
  * Converts the previously imported module to a module of the given file extension.
+ * The converted module file is kept in memory; see GetOutputData.
  * Returns true if an error occurred, or false if successful.
  */
 auto ModuleConvert(std::string output_filename, const std::vector<OptionWrapper>& options_wrapped) -> bool
@@ -186,7 +190,7 @@ auto ModuleConvert(std::string output_filename, const std::vector<OptionWrapper>
 
 	SetStatusType(true);
 
-	if (output->Export(output_filename))
+	if (output->Export(kOutputData))
 	{
 		std::cerr << "Error during export:\n";
 		output->GetStatus().PrintError();
@@ -196,6 +200,15 @@ auto ModuleConvert(std::string output_filename, const std::vector<OptionWrapper>
 	return false;
 }
 
+/*
+ * Returns a view of the module file created by the last successful ModuleConvert call.
+ * The view is only valid until the next call into the module, so JavaScript should copy it.
+ */
+auto GetOutputData() -> emscripten::val
+{
+	return emscripten::val{emscripten::typed_memory_view(kOutputData.size(), reinterpret_cast<const unsigned char*>(kOutputData.data()))};
+}
+
 
 ////////////////////////
 //  Helper functions  //
@@ -257,6 +270,7 @@ EMSCRIPTEN_BINDINGS(dmf2mod) {
 	emscripten::function("getOptionDefinitions", &GetOptionDefinitionsWrapper);
 	emscripten::function("moduleImport", &ModuleImport);
 	emscripten::function("moduleConvert", &ModuleConvert);
+	emscripten::function("getOutputData", &GetOutputData);
 
 	// Register vectors
 	emscripten::register_vector<int>("VectorInt");